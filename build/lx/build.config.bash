@@ -1,4 +1,4 @@
-FilesCard=8
+FilesCard=9
 Files[0]="compileoptionsbase.h"         ; Dirs[0]="src/include"
 Files[1]="compileoptionsbase.cpp"       ; Dirs[1]="src/sdk"
 Files[2]="projectloader.cpp"            ; Dirs[2]="src/sdk"
@@ -7,3 +7,4 @@ Files[4]="compileroptionsdlg.cpp"       ; Dirs[4]="src/plugins/compilergcc"
 Files[5]="compiler_options.xrc"         ; Dirs[5]="src/plugins/compilergcc/resources"
 Files[6]="compiler.cpp"                 ; Dirs[6]="src/sdk"
 Files[7]="macrosmanager.cpp"            ; Dirs[7]="src/sdk"
+Files[8]="macrosmanager.h"              ; Dirs[8]="src/include"
@@ -0,0 +1,145 @@
+/*
+ *  dev/bench/allocs-bounds.cpp
+ *
+ *  Heap allocations of the custom vars and macros hot paths, against an upper bound per
+ *  operation : the exit code is the number of operations above their bound, so that an
+ *  allocation removed once stays removed. Each operation is repeated on a warm state ( vars
+ *  set, template compiled, result cached ) and the count is per call.
+ *
+ *  Needs the counting operator new of allocs.cpp : built with BENCH_COUNT_ALLOCS by
+ *  dev/lx/bench-allocs.bash, with the stubbed sdk of dev/bench/stubs.
+ */
+
+#include <cstdio>
+
+#include <wx/init.h>
+
+#include "sdk_precomp.h"
+#include "manager.h"
+#include "projectmanager.h"
+#include "uservarmanager.h"
+#include "compilerfactory.h"
+#include "macrosmanager.h"
+
+#include "allocs.h"
+
+namespace
+{
+
+const int   s_Reps      =   1000;
+const int   s_Vars      =   100;
+
+/// Operations measured ; the state they run on is set by main().
+struct State
+{
+    cbProject               project;
+    ProjectBuildTarget  *   target;
+    wxString                key;                                                                    //!< an active var of the target
+    wxString                missing;                                                                //!< no var of that name
+    wxString                value;                                                                  //!< out param, reused
+    CustomVar               var;                                                                    //!< out param, reused
+    int                     flags;
+    wxString                buffer;
+    wxString                noMacro;                                                                //!< sources of the expansions
+    wxString                oneVar;
+};
+
+void    OpHasVar            (State & s) { s.target->HasVar(s.key);                                 }
+void    OpHasVarMissing     (State & s) { s.target->HasVar(s.missing);                             }
+void    OpVarHas            (State & s) { s.target->VarHas(s.key);                                 }
+void    OpVarGetFlags       (State & s) { s.target->VarGetFlags(s.key, s.flags);                   }
+void    OpVarGetValue       (State & s) { s.target->VarGetValue(s.key, s.value);                   }
+void    OpVarGet            (State & s) { s.target->VarGet(s.key, s.var);                          }
+void    OpGetVar            (State & s) { s.target->GetVar(s.key);                                 }
+void    OpFindActiveUpper   (State & s) { s.target->VarFindActiveUpper(s.key);                     }
+
+void    OpExpandNoMacro     (State & s)
+{
+    s.buffer.assign(s.noMacro);                                                                     // fits in the buffer's capacity
+    Manager::Get()->GetMacrosManager()->ReplaceMacros(s.buffer, s.target);
+}
+
+void    OpExpandOneVar      (State & s)
+{
+    s.buffer.assign(s.oneVar);
+    Manager::Get()->GetMacrosManager()->ReplaceMacros(s.buffer, s.target);
+}
+
+void    OpEvalOneVar        (State & s)
+{
+    Manager::Get()->GetMacrosManager()->InvalidateResults();                                        // the template stays compiled
+    OpExpandOneVar(s);
+}
+
+struct Check
+{
+    const char  *   name;
+    void        (*  op)(State &);
+    double          bound;                                                                          //!< allocations per call
+};
+
+const Check s_Checks[] =
+{
+    { "HasVar"                              , OpHasVar          ,  0 },
+    { "HasVar ( missing )"                  , OpHasVarMissing   ,  0 },
+    { "VarHas"                              , OpVarHas          ,  0 },
+    { "VarGetFlags"                         , OpVarGetFlags     ,  0 },
+    { "VarFindActiveUpper"                  , OpFindActiveUpper ,  0 },
+    { "GetVar"                              , OpGetVar          ,  0 },
+    { "VarGetValue ( out reused )"          , OpVarGetValue     ,  0 },
+    { "VarGet ( out reused )"               , OpVarGet          ,  0 },
+    { "ReplaceMacros ( no macro )"          , OpExpandNoMacro   ,  0 },
+    { "ReplaceMacros ( 1 var, cached )"     , OpExpandOneVar    ,  0 },
+    { "ReplaceMacros ( 1 var, evaluated )"  , OpEvalOneVar      , 17 },                             // the var and results caches filled again, the LRU node
+    { nullptr                               , nullptr           ,  0 }
+};
+
+} // namespace
+
+int main()
+{
+    wxInitializer   initializer;                                                                    // wxStandardPaths wants an app
+    State           s;
+    int             failed  =   0;
+    //  ............................................................................................
+    if ( ! bench::Counting() )
+    {
+        fprintf(stderr, "> built without BENCH_COUNT_ALLOCS : nothing is counted\n");
+        return 1;
+    }
+
+    s.project.m_Title       =   _T("bench");
+    s.project.m_Filename    =   _T("/work/bench/bench.cbp");
+    s.target                =   s.project.AddBuildTarget(_T("Debug"));
+    for ( int i = 0 ; i < s_Vars ; i++ )
+        s.target->VarSet(wxString::Format(_T("V%d"), i), wxString::Format(_T("/work/deps/lib%d"), i), _T("a comment"), CompileOptionsBase::eVarActive);
+    s.key       =   _T("V0");
+    s.missing   =   _T("NOT_A_VAR");
+    s.noMacro   =   _T("-Wall -O2 -fPIC");
+    s.oneVar    =   _T("-I$(V0)");
+    s.buffer.reserve(256);
+
+    Manager::Get()->GetProjectManager()->m_Project   = &s.project;
+    Manager::Get()->GetProjectManager()->m_Workspace = nullptr;
+    Manager::Get()->GetMacrosManager()->Reset();
+
+    printf("%-38s | allocs / call |  bound |\n", "operation");
+    printf("---------------------------------------+---------------+--------+\n");
+
+    for ( int c = 0 ; s_Checks[c].name ; c++ )
+    {
+        s_Checks[c].op(s);                                                                          // warm : out params sized, template compiled, result cached
+
+        unsigned long long a0 = bench::Allocations();
+        for ( int r = 0 ; r < s_Reps ; r++ )
+            s_Checks[c].op(s);
+        double per = double( bench::Allocations() - a0 ) / s_Reps;
+
+        const bool ok = ( per <= s_Checks[c].bound );
+        printf("%-38s | %13.2f | %6.2f | %s\n", s_Checks[c].name, per, s_Checks[c].bound, ok ? "ok" : "ABOVE");
+        if ( ! ok )
+            ++failed;
+    }
+
+    return failed;
+}
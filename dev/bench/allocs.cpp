@@ -0,0 +1,43 @@
+/*
+ *  dev/bench/allocs.cpp
+ *
+ *  Counting global operator new / delete, see allocs.h. The benchmarks are single-threaded :
+ *  the count is a plain integer.
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include "allocs.h"
+
+#ifdef BENCH_COUNT_ALLOCS
+
+namespace
+{
+unsigned long long  s_Allocations   =   0;
+
+void *  Allocate(std::size_t _i_size)
+{
+    void * p = std::malloc( _i_size ? _i_size : 1 );
+    //  ............................................................................................
+    if ( ! p )
+        throw std::bad_alloc();
+    ++s_Allocations;
+    return p;
+}
+} // namespace
+
+bool                bench::Counting()                                   { return true;              }
+unsigned long long  bench::Allocations()                                { return s_Allocations;     }
+
+void *  operator new        (std::size_t _i_size)                       { return Allocate(_i_size); }
+void *  operator new[]      (std::size_t _i_size)                       { return Allocate(_i_size); }
+void    operator delete     (void * _i_p) noexcept                      { std::free(_i_p);          }
+void    operator delete[]   (void * _i_p) noexcept                      { std::free(_i_p);          }
+
+#else
+
+bool                bench::Counting()                                   { return false;             }
+unsigned long long  bench::Allocations()                                { return 0;                 }
+
+#endif
@@ -0,0 +1,19 @@
+/*
+ *  dev/bench/allocs.h
+ *
+ *  Heap allocations count, a build option : with BENCH_COUNT_ALLOCS defined, allocs.cpp
+ *  replaces the global operator new / delete of the program it is linked in with counting ones.
+ *  On ELF platforms, they are the ones of the shared libraries too : wxString and the std
+ *  containers of the sdk are counted. Without it, nothing is replaced and the count stays 0.
+ */
+
+#ifndef BENCH_ALLOCS_H
+#define BENCH_ALLOCS_H
+
+namespace bench
+{
+bool                Counting();                                                                     //!< built with BENCH_COUNT_ALLOCS
+unsigned long long  Allocations();                                                                  //!< operator new calls since the start
+}
+
+#endif
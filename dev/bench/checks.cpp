@@ -0,0 +1,43 @@
+/*
+ *  dev/bench/checks.cpp
+ *
+ *  See checks.h.
+ */
+
+#include <cstdio>
+
+#include "checks.h"
+
+namespace
+{
+int     s_Failures  =   0;
+} // namespace
+
+bool bench::Check(bool _i_ok, const char * _i_what)
+{
+    printf("  %-74s %s\n", _i_what, _i_ok ? "ok" : "FAILED");
+    if ( ! _i_ok )
+        ++s_Failures;
+
+    return _i_ok;
+}
+
+bool bench::CheckEq(wxString const & _i_got, wxString const & _i_expected, const char * _i_what)
+{
+    if ( Check( _i_got == _i_expected, _i_what ) )
+        return true;
+
+    printf("      got      [%s]\n", (const char*)_i_got     .utf8_str());
+    printf("      expected [%s]\n", (const char*)_i_expected.utf8_str());
+    return false;
+}
+
+void bench::Section(const char * _i_title)
+{
+    printf("%s\n", _i_title);
+}
+
+int bench::Failures()
+{
+    return s_Failures;
+}
@@ -0,0 +1,21 @@
+/*
+ *  dev/bench/checks.h
+ *
+ *  Behaviour checks next to the benchmarks : each Check() prints one line, "ok" or "FAILED",
+ *  and the program returns Failures() so that the dev/lx script fails with it.
+ */
+
+#ifndef BENCH_CHECKS_H
+#define BENCH_CHECKS_H
+
+#include <wx/string.h>
+
+namespace bench
+{
+bool    Check   (bool _i_ok, const char * _i_what);                                                 //!< print the result of a check, count it if it failed
+bool    CheckEq (wxString const & _i_got, wxString const & _i_expected, const char * _i_what);      //!< same, prints both strings when they differ
+void    Section (const char * _i_title);                                                            //!< a title line before a group of checks
+int     Failures();                                                                                 //!< failed checks since the start
+}
+
+#endif
@@ -0,0 +1,255 @@
+/*
+ *  dev/bench/expand-bench.cpp
+ *
+ *  MacrosManager::ReplaceMacros() replaying a corpus of recorded command templates
+ *  ( dev/bench/corpus/commands.txt ) the way a build does : target after target, each line of
+ *  the corpus, the per-file ones once for each file of the target. The synthetic project has
+ *  1 to 200 targets of 1 to 10000 custom vars each. A first build runs on a fresh
+ *  MacrosManager, then rebuilds with nothing changed, which the results cache answers. For
+ *  each : the expansions per second, the heap allocations per expansion ( allocs.cpp, built
+ *  with BENCH_COUNT_ALLOCS ), and the p50 / p99 latency of one ReplaceMacros() ( RecalcVars()
+ *  included when the target changes ).
+ *
+ *  One run per process, so that the first build finds no template compiled by a former run :
+ *      expand-bench <corpus> <vars per target> <targets> [-h]      -h : print the table header
+ *  Built and run on a grid by dev/lx/bench-expand.bash, with the stubbed sdk of dev/bench/stubs.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <wx/init.h>
+
+#include "sdk_precomp.h"
+#include "manager.h"
+#include "projectmanager.h"
+#include "uservarmanager.h"
+#include "compilerfactory.h"
+#include "macrosmanager.h"
+
+#include "allocs.h"
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+const int   s_Files         =   12;                                                                 //!< source files per target
+const int   s_Rebuilds      =   3;
+const int   s_CorpusVars    =   16;                                                                 //!< V0 .. V15 of the corpus
+
+/// What the expansions of one or more builds measured.
+struct Pass
+{
+    Pass() : allocs(0), seconds(0)  {   }
+
+    std::vector< double >   us;                                                                     //!< latency of each expansion
+    unsigned long long      allocs;
+    double                  seconds;
+};
+
+bool    LoadCorpus(const char * _i_path, std::vector< wxString > & _o_lines)
+{
+    std::ifstream   in(_i_path);
+    std::string     line;
+    //  ............................................................................................
+    if ( ! in )
+        return false;
+
+    while ( std::getline(in, line) )
+    {
+        if ( ! line.empty() && ( line[line.size() - 1] == '\r' ) )
+            line.erase(line.size() - 1);
+        if ( line.empty() || ( line[0] == '#' ) )
+            continue;
+        _o_lines.push_back( wxString::FromUTF8(line.c_str()) );
+    }
+
+    return ! _o_lines.empty();
+}
+
+/// Value of the var #_i_var of target #_i_target : a few of the corpus vars reference others.
+wxString    VarValue(int _i_target, int _i_var)
+{
+    switch ( _i_var )
+    {
+        case 0  :   return _T("BENCH");
+        case 1  :   return wxString::Format(_T("1.%d.0"), _i_target);
+        case 3  :   return _T("$(V2)/include/sub");
+        case 7  :   return _T("$(PROJECT_DIR)gen/$(TARGET_NAME)");
+        case 9  :   return wxEmptyString;
+        case 15 :   return _T("\"$(V10)/share\"");
+        default :   return wxString::Format(_T("/work/deps/t%d/v%d"), _i_target, _i_var);
+    }
+}
+
+void    Setup(cbProject & _o_project, std::vector< ProjectBuildTarget * > & _o_targets, int _i_vars, int _i_targets)
+{
+    UserVariableManager *   uvm         =   Manager::Get()->GetUserVariableManager();
+    Compiler            &   compiler    =   CompilerFactory::s_Compiler;
+    //  ............................................................................................
+    _o_project.m_Title      =   _T("bench");
+    _o_project.m_Filename   =   _T("/work/bench/bench.cbp");
+    for ( int f = 0 ; f < s_Files ; f++ )                                                           // the files of TargetLines()
+        _o_project.AddFile( wxString::Format(_T("src/module%d.cpp"), f) );
+    _o_project.SetVar(_T("OPT_LEVEL")       , _T("2"));
+    _o_project.SetVar(_T("CXXFLAGS_EXTRA")  , _T("-fPIC -I$(PROJECT_DIR)extra"));
+    compiler.  SetVar(_T("CXX")             , _T("g++"));
+    compiler.  SetVar(_T("LD")              , _T("g++"));
+    compiler.  SetVar(_T("WX_VERSION")      , _T("31"));
+    compiler.  SetVar(_T("WX_SUFFIX")       , wxEmptyString);
+
+    uvm->m_Vars[_T("WX.INCLUDE")]   =   _T("/opt/wx/include");
+    uvm->m_Vars[_T("WX.LIB")]       =   _T("/opt/wx/lib");
+    uvm->m_Vars[_T("WX.CFLAGS")]    =   _T("-D__WXGTK__ -pthread");
+    uvm->m_Vars[_T("CB")]           =   _T("/work/codeblocks/src");
+    uvm->m_Vars[_T("BOOST.LIB")]    =   _T("/opt/boost/lib");
+
+    for ( int t = 0 ; t < _i_targets ; t++ )
+    {
+        ProjectBuildTarget * target = _o_project.AddBuildTarget(wxString::Format(_T("Target%d"), t));
+
+        for ( int v = 0 ; v < _i_vars ; v++ )
+        {
+            if ( v < s_CorpusVars )
+                target->SetVar(wxString::Format(_T("V%d"), v), VarValue(t, v));
+            else
+                target->SetVar(wxString::Format(_T("FILL_%d"), v), VarValue(t, v));
+        }
+        _o_targets.push_back(target);
+    }
+
+    Manager::Get()->GetProjectManager()->m_Project   = &_o_project;
+    Manager::Get()->GetProjectManager()->m_Workspace = nullptr;
+    Manager::Get()->GetMacrosManager()->Reset();
+}
+
+/// The lines of one target, in build order, the per-file ones substituted beforehand.
+void    TargetLines(std::vector< wxString > const & _i_corpus, std::vector< wxString > & _o_lines)
+{
+    for ( size_t i = 0 ; i < _i_corpus.size() ; i++ )
+    {
+        if ( _i_corpus[i].Find(_T("@FILE@")) == wxNOT_FOUND )
+        {
+            _o_lines.push_back(_i_corpus[i]);
+            continue;
+        }
+
+        for ( int f = 0 ; f < s_Files ; f++ )
+        {
+            wxString line = _i_corpus[i];
+
+            line.Replace(_T("@FILE@")  , wxString::Format(_T("src/module%d.cpp"), f));
+            line.Replace(_T("@OBJECT@"), wxString::Format(_T("src/module%d.o")  , f));
+            _o_lines.push_back(line);
+        }
+    }
+}
+
+void    Build(cbProject & _io_project, std::vector< ProjectBuildTarget * > const & _i_targets, std::vector< wxString > const & _i_lines, Pass & _io_pass)
+{
+    MacrosManager   *   mm  =   Manager::Get()->GetMacrosManager();
+    //  ............................................................................................
+    for ( size_t t = 0 ; t < _i_targets.size() ; t++ )
+    {
+        _io_project.m_Compiling = _i_targets[t];
+
+        for ( size_t i = 0 ; i < _i_lines.size() ; i++ )
+        {
+            wxString                buffer  =   _i_lines[i];                                        // copied before the clock starts
+            unsigned long long      a0      =   bench::Allocations();
+            Clock::time_point       t0      =   Clock::now();
+
+            mm->ReplaceMacros(buffer, _i_targets[t]);
+
+            Clock::time_point       t1      =   Clock::now();
+            _io_pass.allocs     +=  bench::Allocations() - a0;
+            _io_pass.us.push_back( std::chrono::duration< double, std::micro >( t1 - t0 ).count() );
+            _io_pass.seconds    +=  std::chrono::duration< double >( t1 - t0 ).count();
+        }
+    }
+
+    _io_project.m_Compiling = nullptr;
+}
+
+void    Report(int _i_vars, int _i_targets, const char * _i_pass, Pass & _io_pass, double _i_hits)
+{
+    const size_t    n   =   _io_pass.us.size();
+    //  ............................................................................................
+    std::sort(_io_pass.us.begin(), _io_pass.us.end());
+
+    printf("%6d %7d | %-7s | %10lu %12.0f ", _i_vars, _i_targets, _i_pass, (unsigned long)n, n / _io_pass.seconds);
+    if ( bench::Counting() )
+        printf("%10.2f ", double( _io_pass.allocs ) / n);
+    else
+        printf("%10s ", "-");                                                                       // built without BENCH_COUNT_ALLOCS
+    printf("%9.2f %9.2f %8.1f\n", _io_pass.us[ n / 2 ], _io_pass.us[ std::min( n - 1, n * 99 / 100 ) ], _i_hits);
+}
+
+double  ResultsHitRate(MacrosManager::Counters const & _i_c)
+{
+    unsigned long all = _i_c.resultHits + _i_c.resultMisses;
+    //  ............................................................................................
+    return all ? 100.0 * _i_c.resultHits / all : 0;
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    wxInitializer                           initializer;                                            // wxStandardPaths wants an app
+    std::vector< wxString >                 corpus;
+    std::vector< wxString >                 lines;
+    cbProject                               project;
+    std::vector< ProjectBuildTarget * >     targets;
+    Pass                                    first;
+    Pass                                    rebuild;
+    int                                     vars;
+    int                                     count;
+    //  ............................................................................................
+    if ( argc < 4 )
+    {
+        fprintf(stderr, "usage : %s <corpus> <vars per target> <targets> [-h]\n", argv[0]);
+        return 1;
+    }
+    if ( ! LoadCorpus(argv[1], corpus) )
+    {
+        fprintf(stderr, "> no template in the corpus %s\n", argv[1]);
+        return 1;
+    }
+
+    vars    =   atoi(argv[2]);
+    count   =   atoi(argv[3]);
+    if ( ( vars < 1 ) || ( count < 1 ) )
+    {
+        fprintf(stderr, "> at least one var and one target\n");
+        return 1;
+    }
+
+    if ( ( argc > 4 ) && ( strcmp(argv[4], "-h") == 0 ) )
+    {
+        printf("ReplaceMacros() replaying %lu templates, %d files per target\n\n", (unsigned long)corpus.size(), s_Files);
+        printf("  vars targets | build   | expansions  expansions/s allocs/exp   p50 us    p99 us  res hit%%\n");
+        printf("---------------+---------+----------------------------------------------------------------\n");
+    }
+
+    Setup(project, targets, vars, count);
+    TargetLines(corpus, lines);
+
+    Manager::Get()->GetMacrosManager()->ResetCounters();
+    Build(project, targets, lines, first);
+    Report(vars, count, "first", first, ResultsHitRate(Manager::Get()->GetMacrosManager()->GetCounters()));
+
+    Manager::Get()->GetMacrosManager()->ResetCounters();
+    for ( int r = 0 ; r < s_Rebuilds ; r++ )
+        Build(project, targets, lines, rebuild);
+    Report(vars, count, "rebuild", rebuild, ResultsHitRate(Manager::Get()->GetMacrosManager()->GetCounters()));
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ *  dev/bench/macros-bench.cpp
+ *
+ *  MacrosManager::ReplaceMacros() on long synthetic command lines ( 25 KB to 200 KB ), made of
+ *  -I / -L / -l options referencing target, project and compiler vars, global user vars, DOS
+ *  vars, escapes and plain text. Each expansion gets a line never seen before, so that neither
+ *  the templates nor the results caches help : this is the cost of compiling and evaluating.
+ *  A linear expansion keeps the same ns / char whatever the size. A second set of lines is
+ *  mostly literal ( long include lists, one var every 16 options ), a third has no macro at all
+ *  and measures the scan for the delimiters alone. The lines are ASCII : MB/s is the input size
+ *  as written in the project.
+ *
+ *  Built by dev/lx/bench-macros.bash, with the stubbed sdk of dev/bench/stubs : against src/
+ *  ( patched ; with the scalar, SSE2 and AVX2 delimiter scans ), and against src/ref/ with
+ *  BENCH_REF ( former regex loops ).
+ */
+
+#include <chrono>
+#include <cstdio>
+
+#include <wx/init.h>
+
+#include "sdk_precomp.h"
+#include "manager.h"
+#include "projectmanager.h"
+#include "uservarmanager.h"
+#include "compilerfactory.h"
+#include "macrosmanager.h"
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+/// Options of a link line, cycled until the wanted size ; %d is the index of the var.
+const wxChar * const s_Pieces[] =
+{
+    _T("-I$(INC_%d)/include "),
+    _T("-L$(TARGET_OUTPUT_DIR)lib%d "),
+    _T("-l$(LIB_%d) "),
+    _T("-I$(#sdk.include)/part%d "),
+    _T("-D%%LIBDEF_%d%%=1 "),
+    _T("obj/Debug/src/module%d.o "),
+    _T("-Wl,-rpath,$$ORIGIN/%d "),
+    _T("-I${PROJ_%d}/src "),
+    _T("$(COMP_%d) "),
+    nullptr
+};
+
+/// Options of an include list : literal, but for one var every 16 options.
+const wxChar * const s_Literal[] =
+{
+    _T("-I$(INC_%d)/include "),
+    _T("-I/usr/include/x86_64-linux-gnu/deps/lib%d/include "),
+    _T("-I/opt/toolchains/sysroot/usr/local/include/module%d "),
+    _T("-isystem /usr/lib/gcc/x86_64-linux-gnu/9/include/part%d "),
+    _T("-DNDEBUG_LEVEL_%d=1 "),
+    _T("-Wno-unused-parameter -Wno-missing-field-initializers -fPIC%d "),
+    _T("-L/usr/lib/x86_64-linux-gnu/deps/lib%d "),
+    _T("-Wl,--as-needed,-rpath-link,/opt/toolchains/sysroot/lib%d "),
+    _T("-I/home/build/work/project/src/components/c%d/include "),
+    _T("-I/home/build/work/project/src/components/c%d/private "),
+    _T("-fvisibility=hidden -ffunction-sections -fdata-sections -g%d "),
+    _T("-I/home/build/work/project/third_party/t%d/include "),
+    _T("-MMD -MP -MF obj/Release/src/components/c%d.d "),
+    _T("-I/usr/include/glib-2.0 -I/usr/lib/x86_64-linux-gnu/glib-2.0/include/g%d "),
+    _T("-I/usr/include/gtk-3.0/unix-print/u%d "),
+    _T("-lpthread -ldl -lm -lz%d "),
+    nullptr
+};
+const wxChar * const * s_NoMacro = s_Literal + 1;                                                   //!< the same without the var : only the scan for a delimiter
+
+const int s_Vars = 100;                                                                             //!< INC_, LIB_, LIBDEF_ and PROJ_ / COMP_ vars defined
+
+wxString    MakeLine(const wxChar * const * _i_pieces, size_t _i_chars)
+{
+    wxString    line;
+    int         k       =   0;
+    //  ............................................................................................
+    line.reserve(_i_chars + 64);
+
+    while ( line.length() < _i_chars )
+    {
+        for ( int p = 0 ; _i_pieces[p] && ( line.length() < _i_chars ) ; p++ )
+            line << wxString::Format(_i_pieces[p], k % s_Vars);
+        ++k;
+    }
+
+    return line;
+}
+
+void    Setup(cbProject & _o_project, ProjectBuildTarget * & _o_target)
+{
+    Compiler & compiler = CompilerFactory::s_Compiler;
+    //  ............................................................................................
+    _o_project.m_Title      =   _T("bench");
+    _o_project.m_Filename   =   _T("/work/bench/bench.cbp");
+    _o_project.AddFile(_T("src/main.cpp"));
+    _o_target = _o_project.AddBuildTarget(_T("Debug"));
+
+    for ( int i = 0 ; i < s_Vars ; i++ )
+    {
+        _o_target ->SetVar(wxString::Format(_T("INC_%d")   , i), wxString::Format(_T("/work/deps/lib%d"), i));
+        _o_target ->SetVar(wxString::Format(_T("LIB_%d")   , i), wxString::Format(_T("dep%d"), i));
+        _o_target ->SetVar(wxString::Format(_T("LIBDEF_%d"), i), wxString::Format(_T("HAVE_DEP%d"), i));
+        _o_project. SetVar(wxString::Format(_T("PROJ_%d")  , i), _T("$(PROJECT_DIR)sub"));          // nested reference
+        compiler.   SetVar(wxString::Format(_T("COMP_%d")  , i), wxString::Format(_T("-march=native%d"), i));
+    }
+
+    Manager::Get()->GetUserVariableManager()->m_Vars[_T("SDK.INCLUDE")] = _T("/opt/sdk/include");
+    Manager::Get()->GetProjectManager()->m_Project   = &_o_project;
+    Manager::Get()->GetProjectManager()->m_Workspace = nullptr;
+    Manager::Get()->GetMacrosManager()->Reset();
+}
+
+void    Bench(ProjectBuildTarget * _i_target, const wxChar * const * _i_pieces, size_t _i_chars)
+{
+    MacrosManager   *   mm      =   Manager::Get()->GetMacrosManager();
+    const wxString      line    =   MakeLine(_i_pieces, _i_chars);
+#ifdef BENCH_REF
+    const int           reps    =   1;                                                              // quadratic : seconds per line
+#else
+    const int           reps    =   _i_chars < 100000 ? 8 : 4;
+#endif
+    size_t              out     =   0;
+    double              best    =   0;
+    //  ............................................................................................
+    for ( int r = 0 ; r < reps ; r++ )
+    {
+        wxString            buffer  =   wxString::Format(_T("%d "), r) + line;                      // never expanded before
+        Clock::time_point   t0      =   Clock::now();
+
+        mm->ReplaceMacros(buffer, _i_target);
+
+        double ms = std::chrono::duration< double, std::milli >( Clock::now() - t0 ).count();
+        if ( ( r == 0 ) || ( ms < best ) )
+            best = ms;
+        out += buffer.length();
+    }
+
+    printf("%8lu | %12.3f %10.1f %10.2f | %lu\n",
+           (unsigned long)line.length(), best, line.length() / best / 1000.0, best * 1e6 / line.length(),
+           (unsigned long)( out / reps ));                                                          // output size, and nothing optimized out
+}
+
+void    Table(ProjectBuildTarget * _i_target, const wxChar * const * _i_pieces, const char * _i_title)
+{
+    printf("%s\n", _i_title);
+    printf("   input |    ms / line       MB/s    ns/char | output\n");
+    printf("---------+-----------------------------------+--------\n");
+
+    Bench(_i_target, _i_pieces,  25000);
+    Bench(_i_target, _i_pieces,  50000);
+    Bench(_i_target, _i_pieces, 100000);
+    Bench(_i_target, _i_pieces, 200000);
+    printf("\n");
+}
+
+} // namespace
+
+int main()
+{
+    wxInitializer           initializer;                                                            // wxStandardPaths wants an app
+    cbProject               project;
+    ProjectBuildTarget  *   target;
+    //  ............................................................................................
+    Setup(project, target);
+
+#if defined(BENCH_REF)
+    printf("former ReplaceMacros() ( src/ref )\n\n");
+#elif defined(MACROS_SCAN_SCALAR)
+    printf("ReplaceMacros() ( src, scalar scan )\n\n");
+#elif defined(__AVX2__)
+    printf("ReplaceMacros() ( src, AVX2 scan )\n\n");
+#else
+    printf("ReplaceMacros() ( src, SSE2 scan )\n\n");
+#endif
+
+    Table(target, s_Pieces,  "lines dense in vars");
+    Table(target, s_Literal, "include lists ( 1 var / 16 options )");
+    Table(target, s_NoMacro, "include lists without any macro");
+
+#ifndef BENCH_REF
+    const MacrosManager::Counters & c = Manager::Get()->GetMacrosManager()->GetCounters();
+    printf("templates : %lu hits, %lu misses ; results : %lu hits, %lu misses ; vars : %lu hits, %lu misses\n",
+           c.templateHits, c.templateMisses, c.resultHits, c.resultMisses, c.varHits, c.varMisses);
+#endif
+
+    return 0;
+}
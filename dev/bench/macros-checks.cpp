@@ -0,0 +1,722 @@
+/*
+ *  dev/bench/macros-checks.cpp
+ *
+ *  Behaviour checks of the MacrosManager caches : each section checks one of them on a small
+ *  project, with the counters of MacrosManager::GetCounters() telling a cached answer from a
+ *  computed one. The exit code is the number of failed checks. Built with the stubbed sdk of
+ *  dev/bench/stubs by dev/lx/checks.bash.
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include <wx/init.h>
+#include <wx/utils.h>
+
+#include "sdk_precomp.h"
+#include "manager.h"
+#include "projectmanager.h"
+#include "uservarmanager.h"
+#include "compilerfactory.h"
+#include "logmanager.h"
+#include "scriptingmanager.h"
+#include "macrosmanager.h"
+
+#include "checks.h"
+
+namespace
+{
+
+/// The project the sections expand against ; each section starts from Fixture::Reset().
+struct Fixture
+{
+    cbProject               project;
+    ProjectBuildTarget  *   target;
+
+    Fixture()
+    {
+        project.m_Title     =   _T("checks");
+        project.m_Filename  =   _T("/work/checks/checks.cbp");
+        target              =   project.AddBuildTarget(_T("Debug"));
+
+        Manager::Get()->GetProjectManager()->m_Project   = &project;
+        Manager::Get()->GetProjectManager()->m_Workspace = nullptr;
+    }
+
+    void            Reset()
+    {
+        project.VarUnsetAll();
+        target ->VarUnsetAll();
+        Manager::Get()->GetUserVariableManager()->m_Vars.clear();
+        Mm()->Reset();
+        Mm()->InvalidateResults();
+        Mm()->ResetCounters();
+    }
+
+    wxString        Expand(wxString const & _i_src)
+    {
+        wxString buffer = _i_src;
+        //  ........................................................................................
+        Mm()->ReplaceMacros(buffer, target);
+        return buffer;
+    }
+
+    static  MacrosManager                   *   Mm      ()  { return Manager::Get()->GetMacrosManager();    }
+    static  MacrosManager::Counters const   &   Counters()  { return Mm()->GetCounters();                   }
+};
+
+//  ................................................................................................
+//  GetMacros() merges the layers once per macro state
+//  ................................................................................................
+void    CheckMerge(Fixture & f)
+{
+    bench::Section("GetMacros() merge");
+    f.Reset();
+
+    f.target->VarSet(_T("V0"), _T("v0"), wxEmptyString, CompileOptionsBase::eVarActive);
+    f.Expand(_T("$(V0)"));                                                                          // RecalcVars()
+    f.Mm()->GetMacros();
+    f.Mm()->ResetCounters();
+
+    f.Mm()->GetMacros();
+    bench::Check( f.Counters().macrosMerges == 0, "unchanged state : no merge" );
+
+    f.target->VarSetValue(_T("V0"), _T("edited"));
+    MacrosMap const & m = f.Mm()->GetMacros();
+    MacrosMap::const_iterator it = m.find(_T("V0"));
+    bench::Check( ( it != m.end() ) && ( it->second == _T("edited") ), "target var edit seen without RecalcVars()" );
+    bench::Check( f.Counters().macrosMerges == 1, "target var edit : one merge" );
+
+    f.Mm()->GetMacros();
+    f.Mm()->GetMacros();
+    bench::Check( f.Counters().macrosMerges == 1, "after the edit : no merge anymore" );
+}
+
+//  ................................................................................................
+//  the compiled templates are kept in a LRU of 1024 entries
+//  ................................................................................................
+void    CheckTemplatesLru(Fixture & f)
+{
+    const unsigned long capacity    =   1024;
+    //  ............................................................................................
+    bench::Section("templates LRU");
+    f.Reset();
+
+    for ( unsigned long i = 0 ; i < capacity ; i++ )                                                // push the former templates out
+        f.Expand( wxString::Format(_T("$(LRU_FILL_%lu)"), i) );
+    f.Mm()->ResetCounters();
+
+    for ( unsigned long i = 0 ; i < capacity ; i++ )
+        f.Expand( wxString::Format(_T("$(LRU_%lu)"), i) );
+    bench::Check( ( f.Counters().templateMisses == capacity ) && ( f.Counters().templateEvictions == capacity ), "1024 new templates : compiled, the 1024 former ones evicted" );
+
+    f.Mm()->InvalidateResults();                                                                    // the results cache would answer first
+    f.Expand(_T("$(LRU_0)"));
+    bench::Check( f.Counters().templateHits == 1, "the oldest one is still there" );
+
+    f.Expand( wxString::Format(_T("$(LRU_%lu)"), capacity) );
+    bench::Check( f.Counters().templateEvictions == capacity + 1, "one more template : one eviction" );
+
+    f.Mm()->InvalidateResults();
+    f.Mm()->ResetCounters();
+    f.Expand(_T("$(LRU_0)"));
+    bench::Check( f.Counters().templateHits == 1, "the template used again was kept" );
+    f.Expand(_T("$(LRU_1)"));
+    bench::Check( ( f.Counters().templateMisses == 1 ) && ( f.Counters().templateEvictions == 1 ), "the least recently used one was evicted" );
+}
+
+//  ................................................................................................
+//  the results cache ; what reads a global user var or the environment is not kept
+//  ................................................................................................
+void    CheckResults(Fixture & f)
+{
+    std::map< wxString, wxString > & globals = Manager::Get()->GetUserVariableManager()->m_Vars;
+    //  ............................................................................................
+    bench::Section("results cache");
+    f.Reset();
+
+    f.target->VarSet(_T("A"), _T("a"), wxEmptyString, CompileOptionsBase::eVarActive);
+    f.target->VarSet(_T("B"), _T("b"), wxEmptyString, CompileOptionsBase::eVarActive);
+    f.Expand(_T("$(A)-x"));
+    f.Mm()->ResetCounters();
+
+    bench::CheckEq( f.Expand(_T("$(A)-x")), _T("a-x"), "same input : same result" );
+    bench::Check( f.Counters().resultHits == 1, "same input : answered from the cache" );
+
+    f.target->VarSetValue(_T("B"), _T("b2"));
+    f.Expand(_T("$(A)-x"));
+    bench::Check( ( f.Counters().resultHits == 2 ) && ( f.Counters().resultDropped == 0 ), "edit of a var it does not read : still cached" );
+
+    f.target->VarSetValue(_T("A"), _T("a2"));
+    bench::Check( f.Counters().resultDropped == 1, "edit of a var it reads : VarsChanged() drops it" );
+    bench::CheckEq( f.Expand(_T("$(A)-x")), _T("a2-x"), "edit of a var it reads : evaluated again" );
+    //  ............................................................................................
+    globals[_T("CHK")] = _T("one");
+    f.target->VarSet(_T("G"), _T("$(#chk)/x"), wxEmptyString, CompileOptionsBase::eVarActive);
+    f.Expand(_T("$(#chk) $(G)"));
+    globals[_T("CHK")] = _T("two");
+    bench::CheckEq( f.Expand(_T("$(#chk) $(G)")), _T("two two/x"), "global user var edit : seen without InvalidateResults()" );
+
+    wxSetEnv(_T("MACROS_CHECKS_ENV"), _T("one"));
+    f.Expand(_T("$(MACROS_CHECKS_ENV)"));
+    wxSetEnv(_T("MACROS_CHECKS_ENV"), _T("two"));
+    f.Mm()->EnvChanged(_T("MACROS_CHECKS_ENV"));
+    bench::CheckEq( f.Expand(_T("$(MACROS_CHECKS_ENV)")), _T("two"), "environment change : the result was not kept" );
+    wxUnsetEnv(_T("MACROS_CHECKS_ENV"));
+    f.Mm()->EnvChanged(_T("MACROS_CHECKS_ENV"));
+    bench::CheckEq( f.Expand(_T("$(MACROS_CHECKS_ENV)")), wxEmptyString, "environment var unset : the result was not kept" );
+    //  ............................................................................................
+    f.Reset();
+    f.target->VarSet(_T("A"), _T("a"), wxEmptyString, CompileOptionsBase::eVarActive);
+    f.Expand(_T("$(A)-first"));
+    f.Expand(_T("$(A)-second"));
+
+    for ( int i = 0 ; i < 4094 ; i++ )                                                              // the cache full, at its least capacity
+    {
+        if ( i == 2000 )
+            f.Expand(_T("$(A)-first"));
+
+        f.Expand( wxString::Format(_T("$(A)-%d"), i) );
+    }
+    f.Mm()->ResetCounters();
+
+    f.Expand(_T("$(A)-last"));
+    bench::Check( f.Counters().resultEvictions == 1, "cache full : one result evicted, not all" );
+    f.Expand(_T("$(A)-first"));
+    bench::Check( f.Counters().resultHits == 1, "cache full : the recently used result kept" );
+    f.Expand(_T("$(A)-second"));
+    bench::Check( f.Counters().resultMisses == 2, "cache full : the least recently used result evicted" );
+}
+
+//  ................................................................................................
+//  the var edits of any CompileOptionsBase reach VarsChanged() through its listener
+//  ................................................................................................
+void    CheckVarsListener(Fixture & f)
+{
+    Compiler                        *   compiler    =   CompilerFactory::GetCompiler(_T("gcc"));
+    CompileOptionsBase::VarBatch        batch(f.project);
+    //  ............................................................................................
+    bench::Section("vars listener");
+    f.Reset();
+
+    f.project.VarSet(_T("P"), _T("p"), wxEmptyString, CompileOptionsBase::eVarActive);
+    compiler->VarSet(_T("C"), _T("c"), wxEmptyString, CompileOptionsBase::eVarActive);
+    f.Expand(_T("$(P)-p"));
+    f.Expand(_T("$(C)-c"));
+    f.Mm()->ResetCounters();
+
+    batch.SetValue(_T("P"), _T("p2"));
+    batch.Commit();
+    bench::Check( f.Counters().resultDropped == 1, "project VarBatch::Commit() : the result reading it dropped" );
+    bench::CheckEq( f.Expand(_T("$(P)-p")), _T("p2-p"), "project VarBatch::Commit() : evaluated again" );
+
+    compiler->VarSetValue(_T("C"), _T("c2"));
+    bench::Check( f.Counters().resultDropped == 2, "compiler var edit : the result reading it dropped" );
+    bench::CheckEq( f.Expand(_T("$(C)-c")), _T("c2-c"), "compiler var edit : evaluated again" );
+
+    compiler->VarUnsetAll();
+    bench::CheckEq( f.Expand(_T("$(C)-c")), _T("-c"), "compiler VarUnsetAll() : evaluated again" );
+    //  ............................................................................................
+    f.target->VarSet(_T("T"), _T("t"), wxEmptyString, CompileOptionsBase::eVarActive);
+    f.Expand(_T("$(T)-t"));
+    f.Mm()->ResetCounters();
+
+    const unsigned long generation = f.target->GetOptionsGeneration();
+
+    f.project.VarSetValue(_T("P"), _T("p3"));
+    bench::Check( f.project.GetModified(), "project var edit : the project modified" );
+    bench::Check( f.target->GetOptionsGeneration() == generation, "project var edit : not passed down to the targets" );
+    bench::CheckEq( f.Expand(_T("$(T)-t")), _T("t-t"), "project var edit : an unrelated input expanded" );
+    bench::Check( f.Counters().resultHits == 1, "project var edit : an unrelated input still cached" );
+}
+
+//  ................................................................................................
+//  resolved vars, cycles reported once and left unexpanded
+//  ................................................................................................
+void    CheckCycles(Fixture & f)
+{
+    LogManager  *   log     =   Manager::Get()->GetLogManager();
+    int             logged;
+    //  ............................................................................................
+    bench::Section("resolved vars, cycles");
+    f.Reset();
+
+    f.target->VarSet(_T("R1")   , _T("$(R2)/r1")    , wxEmptyString, CompileOptionsBase::eVarActive);
+    f.target->VarSet(_T("R2")   , _T("r2")          , wxEmptyString, CompileOptionsBase::eVarActive);
+    f.target->VarSet(_T("SELF") , _T("x$(SELF)")    , wxEmptyString, CompileOptionsBase::eVarActive);
+    f.target->VarSet(_T("CA")   , _T("$(CB)/a")     , wxEmptyString, CompileOptionsBase::eVarActive);
+    f.target->VarSet(_T("CB")   , _T("$(CC)/b")     , wxEmptyString, CompileOptionsBase::eVarActive);
+    f.target->VarSet(_T("CC")   , _T("$(CA)/c")     , wxEmptyString, CompileOptionsBase::eVarActive);
+
+    bench::CheckEq( f.Expand(_T("$(R1) $(R1)")), _T("r2/r1 r2/r1"), "nested var : expanded" );
+    bench::Check( ( f.Counters().varMisses == 2 ) && ( f.Counters().varHits == 1 ), "nested var : resolved once, then looked up" );
+
+    logged = log->m_Warnings;
+    bench::CheckEq( f.Expand(_T("$(SELF)")), _T("x$(SELF)"), "A = x$(A) : the reference met again is left unexpanded" );
+    bench::Check( f.Counters().varCycles == 1, "A = x$(A) : one cycle met" );
+    bench::Check( ( log->m_Warnings == logged + 1 ) && ( log->m_LastWarning.Find(_T("SELF -> SELF")) != wxNOT_FOUND ), "A = x$(A) : logged with its chain" );
+
+    bench::CheckEq( f.Expand(_T("$(SELF) - $(SELF)")), _T("x$(SELF) - x$(SELF)"), "A = x$(A) again : same result" );
+    bench::Check( log->m_Warnings == logged + 1, "A = x$(A) again : not logged again" );
+
+    bench::CheckEq( f.Expand(_T("$(CA)")), _T("$(CA)/c/b/a"), "A -> B -> C -> A : left unexpanded where met again" );
+    bench::Check( ( log->m_Warnings == logged + 2 ) && ( log->m_LastWarning.Find(_T("CA -> CB -> CC -> CA")) != wxNOT_FOUND ), "A -> B -> C -> A : logged with its chain" );
+    bench::CheckEq( f.Expand(_T("$(CB)")), _T("$(CB)/a/c/b"), "entered at B : B is not taken from the resolution through A" );
+}
+
+//  ................................................................................................
+//  the environment fallback, a snapshot until EnvChanged() or InvalidateResults()
+//  ................................................................................................
+void    CheckEnv(Fixture & f)
+{
+    bench::Section("environment fallback");
+    f.Reset();
+
+    wxSetEnv(_T("MACROS_CHECKS_ENV"), _T("one"));
+    bench::CheckEq( f.Expand(_T("$(MACROS_CHECKS_ENV) $(MACROS_CHECKS_ENV)")), _T("one one"), "environment var : expanded" );
+    bench::Check( ( f.Counters().envMisses == 1 ) && ( f.Counters().envHits == 1 ), "environment var : read once in an expansion" );
+
+    f.Expand(_T("$(MACROS_CHECKS_NONE) $(MACROS_CHECKS_NONE)"));
+    bench::Check( ( f.Counters().envMisses == 2 ) && ( f.Counters().envHits == 2 ), "absent environment var : read once in an expansion too" );
+
+    f.Expand(_T("$(MACROS_CHECKS_ENV) $(MACROS_CHECKS_NONE)"));
+    bench::Check( ( f.Counters().envMisses == 2 ) && ( f.Counters().envHits == 4 ), "next expansion : the snapshot, absent names included" );
+
+    wxSetEnv(_T("MACROS_CHECKS_ENV"), _T("behind"));
+    bench::CheckEq( f.Expand(_T("$(MACROS_CHECKS_ENV)")), _T("one"), "changed behind C::B : still the snapshot" );
+    f.Mm()->InvalidateResults();
+    bench::CheckEq( f.Expand(_T("$(MACROS_CHECKS_ENV)")), _T("behind"), "InvalidateResults() : read again" );
+    wxSetEnv(_T("MACROS_CHECKS_ENV"), _T("one"));
+    f.Mm()->EnvChanged(_T("MACROS_CHECKS_ENV"));
+
+    f.Expand(_T("[[/*pure*/ env]]"));
+    f.Expand(_T("[[/*pure*/ env]]"));
+    bench::Check( f.Counters().scriptPureHits == 1, "/*pure*/ script : run once" );
+    wxSetEnv(_T("MACROS_CHECKS_ENV"), _T("two"));
+    f.Mm()->EnvChanged(_T("MACROS_CHECKS_ENV"));
+    f.Expand(_T("[[/*pure*/ env]]"));
+    bench::Check( f.Counters().scriptPureHits == 1, "EnvChanged() : the /*pure*/ script runs again" );
+    bench::CheckEq( f.Expand(_T("$(MACROS_CHECKS_ENV)")), _T("two"), "EnvChanged() : the new value" );
+
+    wxUnsetEnv(_T("MACROS_CHECKS_ENV"));
+}
+
+//  ................................................................................................
+//  the builtin macros are slots, found through a perfect hash of their names
+//  ................................................................................................
+void    CheckBuiltins(Fixture & f)
+{
+    MacrosMap       macros;
+    int             names       =   0;
+    int             wrong       =   0;
+    //  ............................................................................................
+    bench::Section("builtin slots");
+    f.Reset();
+
+    f.Expand(_T("$(PROJECT_NAME)"));                                                                // RecalcVars()
+    macros = f.Mm()->GetMacros();                                                                   // every alias of every slot
+
+    for ( MacrosMap::const_iterator it = macros.begin() ; it != macros.end() ; ++it )
+    {
+        if ( it->first.Find(_T("NOW")) != wxNOT_FOUND )                                             // may tick between both reads
+            continue;
+        if ( it->first.Find(_T('-')) != wxNOT_FOUND )                                               // APP-PATH, ... : not a $( ) name
+            continue;
+
+        names++;
+        if ( f.Expand( _T("$(") + it->first + _T(")") ) != it->second )
+        {
+            printf("      %s\n", (const char*)it->first.utf8_str());
+            wrong++;
+        }
+    }
+    bench::Check( ( names > 80 ) && ( wrong == 0 ), "each name of GetMacros() expands to its value" );
+
+    bench::CheckEq( f.Expand(_T("$(PROJECT_DIR)|$(PROJECTDIR)|$(PROJECT_DIRECTORY)")), _T("/work/checks/|/work/checks/|/work/checks/"), "aliases share their slot" );
+    bench::CheckEq( f.Expand(_T("$(PROJECT_DI)$(PROJECT_DIRX)$(XPROJECT_DIR)$(ACTIVE_EDITOR_SELECTION_)")), wxEmptyString, "near names are not builtins" );
+}
+
+//  ................................................................................................
+//  the costly builtins are computed by their first reference, not by RecalcVars()
+//  ................................................................................................
+void    CheckLazySlots(Fixture & f)
+{
+    unsigned long   n;
+    //  ............................................................................................
+    bench::Section("lazy builtins");
+    f.Reset();
+
+    f.target->VarSet(_T("FOO"), _T("foo"), wxEmptyString, CompileOptionsBase::eVarActive);
+    bench::CheckEq( f.Expand(_T("x $(FOO) y")), _T("x foo y"), "a template without builtin" );     // RecalcVars()
+    bench::Check( f.Counters().builtinFetches == 0, "RecalcVars() computes no lazy builtin" );
+
+    f.Expand(_T("$(TODAY)"));
+    bench::Check( f.Counters().builtinFetches == 1, "first date : computed" );
+    f.Expand(_T("$(NOW) $(WEEKDAY_UTC) $(DAYCOUNT)"));
+    bench::Check( f.Counters().builtinFetches == 1, "the other dates : computed with it" );
+
+    bench::CheckEq( f.Expand(_T("$(ACTIVE_EDITOR_LINE) $(ACTIVE_EDITOR_COLUMN_0)")), _T("-1 -1"), "no active editor : invalid position" );
+    bench::Check( f.Counters().builtinFetches == 2, "the editor position : computed once for its slots" );
+
+    f.Expand(_T("$(GET_TEMP_DIR)"));                                                                // computed once while C::B runs,
+    n = f.Counters().builtinFetches;                                                                // may be by a former section
+    f.Expand(_T("$(GET_TEMP_DIR)/a"));
+    bench::Check( f.Counters().builtinFetches == n, "GET_TEMP_DIR again : not computed again" );
+
+    f.Mm()->Reset();                                                                                // next RecalcVars()
+    f.Mm()->ResetCounters();
+    f.Expand(_T("$(TODAY) $(ACTIVE_EDITOR_LINE) $(GET_TEMP_DIR)"));
+    bench::Check( f.Counters().builtinFetches == 2, "next RecalcVars() : dates, editor computed again, std paths not" );
+}
+
+//  ................................................................................................
+//  $if( ) : the comparisons, bare conditions, $ifnum( ), nested $if
+//  ................................................................................................
+void    CheckIf(Fixture & f)
+{
+    bench::Section("$if");
+    f.Reset();
+
+    f.target->VarSet(_T("FOO"), _T("foo"), wxEmptyString, CompileOptionsBase::eVarActive);
+    f.target->VarSet(_T("N")  , _T("10") , wxEmptyString, CompileOptionsBase::eVarActive);
+
+    bench::CheckEq( f.Expand(_T("$if(a==a){y}{n}$if( a = a ){y}{n}$if(a==b){y}{n}")), _T("yyn"), "==" );
+    bench::CheckEq( f.Expand(_T("$if(a!=b){y}{n}$if(a != a){y}{n}")), _T("yn"), "!=" );
+    bench::CheckEq( f.Expand(_T("$if(a<b){y}{n}$if(b<a){y}{n}$if(9<10){y}{n}")), _T("ynn"), "< , on the text : 9 > 10" );
+    bench::CheckEq( f.Expand(_T("$if(a<=a){y}{n}$if(b<=a){y}{n}")), _T("yn"), "<=" );
+    bench::CheckEq( f.Expand(_T("$if(b>a){y}{n}$if(a>b){y}{n}")), _T("yn"), ">" );
+    bench::CheckEq( f.Expand(_T("$if(a>=a){y}{n}$if(a>=b){y}{n}")), _T("yn"), ">=" );
+    bench::CheckEq( f.Expand(_T("$if(${FOO}==foo){y}{n}$if(${FOO}==${FOO}){y}{n}$if($FOO!=foo){y}{n}")), _T("nyy"), "the operands are compared as written" );
+
+    bench::CheckEq( f.Expand(_T("$if($(FOO)==foo){y}{n}")), _T("(foo==foo){y}{n}"), "holding a ')' : no $if, as svn 11914" );
+
+    bench::CheckEq( f.Expand(_T("$if(${FOO}){y}{n}$if($(FOO)){y}{n}$if(${EMPTY}){y}{n}$if(0){y}{n}$if(false){y}{n}")), _T("yynnn"), "bare : the expanded condition" );
+    bench::CheckEq( f.Expand(_T("$if(==){y}{n}$if(){y}{n}")), _T("nn"), "no operand : false" );
+
+    bench::CheckEq( f.Expand(_T("$ifnum($(N)>9){y}{n}$ifnum($(N)<9){y}{n}$ifnum(10==10.0){y}{n}")), _T("yny"), "$ifnum : the expanded operands, as numbers" );
+    bench::CheckEq( f.Expand(_T("$ifnum($(FOO)>1){y}{n}$ifnum($(N)){y}{n}$ifnum(0){y}{n}")), _T("nyn"), "$ifnum : not a number, bare" );
+
+    bench::CheckEq( f.Expand(_T("$if(1){$if(${FOO}){in}{out}}{no} $if(0){x}{$if(a==a){y}{n}}")), _T("in y"), "nested in a clause" );
+    bench::CheckEq( f.Expand(_T("$if($if(0){a}{b}){y}{n}$if($if(0){a}){y}{n}")), _T("yn"), "nested in the condition" );
+}
+
+//  ................................................................................................
+//  [[script]] : closures compiled once, /*pure*/ snippets, failing snippets
+//  ................................................................................................
+void    CheckScripts(Fixture & f)
+{
+    ScriptingManager    *   sm      =   Manager::Get()->GetScriptingManager();
+    int                     errors  =   sm->m_Errors;
+    int                     loads   =   sm->m_Loads;
+    //  ............................................................................................
+    bench::Section("[[script]]");
+    f.Reset();
+
+    bench::CheckEq( f.Expand(_T("[[/*pure*/ p]]")), _T("/*pure*/ p"), "a /*pure*/ snippet" );
+    f.Expand(_T("<[[/*pure*/ p]]>"));
+    bench::Check( ( f.Counters().scriptRuns == 1 ) && ( f.Counters().scriptPureHits == 1 ), "run once, then its output is reused" );
+
+    f.target->VarSet(_T("V"), _T("v"), wxEmptyString, CompileOptionsBase::eVarActive);
+    f.Expand(_T("[[/*pure*/ p]]"));
+    bench::Check( ( f.Counters().scriptRuns == 2 ) && ( f.Counters().scriptPureHits == 1 ), "a var edit : run again" );
+
+    f.Expand(_T("[[q]]"));
+    f.Expand(_T("[[q]]"));
+    bench::Check( ( f.Counters().scriptRuns == 4 ) && ( f.Counters().scriptCompiles == 2 ), "not /*pure*/ : run each time, compiled once" );
+
+    f.Mm()->ResetCounters();
+    bench::CheckEq( f.Expand(_T("a[[throw x]]b")), _T("ab"), "a failing snippet expands to nothing" );
+    bench::Check( ( sm->m_Errors == errors + 1 ) && ( f.Counters().scriptRuns == 1 ), "its errors displayed, it is run once" );
+    bench::Check( sm->m_Loads == loads, "no LoadBufferRedirectOutput()" );
+
+    f.Expand(_T("c[[throw x]]d"));
+    bench::Check( ( sm->m_Errors == errors + 1 ) && ( f.Counters().scriptRuns == 1 ), "failed : not run nor reported again" );
+    f.target->VarSetValue(_T("V"), _T("v2"));
+    f.Expand(_T("a[[throw x]]b"));
+    bench::Check( ( sm->m_Errors == errors + 2 ) && ( f.Counters().scriptRuns == 2 ), "failed, then a var edit : run again" );
+}
+
+//  ................................................................................................
+//  the path functions convert their result by ConvertSeparators(), as UnixFilename()
+//  ................................................................................................
+void    CheckSeparators(Fixture & f)
+{
+    static const wxChar * const paths[] =
+    {
+        _T("\\\\server\\share\\dir")    , _T("\\\\server/share//dir/")  , _T("\\\\\\/server\\\\x")  ,
+        _T("\\\\")                      , _T("\\")                      , _T("/")                   ,
+        _T("a//b\\\\c")                 , _T("///a/\\/b")               , _T("a\\/\\/")             ,
+        _T("//server/share")            , _T("x\\\\\\\\y")              , _T("noseparator")
+    };
+    int wrong = 0;
+    //  ............................................................................................
+    bench::Section("path separators");
+    f.Reset();
+
+    for ( size_t i = 0 ; i < sizeof(paths) / sizeof(paths[0]) ; i++ )
+    {
+        wxString const  path    (paths[i]);
+        wxString const  toUnix  =   f.Expand(_T("$TO_UNIX_PATH{")    + path + _T("}"));
+        wxString const  toWin   =   f.Expand(_T("$TO_WINDOWS_PATH{") + path + _T("}"));
+
+        if ( ( toUnix != UnixFilename(path, wxPATH_UNIX) ) || ( toWin != UnixFilename(path, wxPATH_WIN) ) )
+        {
+            printf("      %s => [%s] [%s]\n", (const char*)path.utf8_str(), (const char*)toUnix.utf8_str(), (const char*)toWin.utf8_str());
+            wrong++;
+        }
+    }
+    bench::Check( wrong == 0, "$TO_UNIX_PATH{ } / $TO_WINDOWS_PATH{ } : as UnixFilename()" );
+
+    bench::CheckEq( f.Expand(_T("$TO_UNIX_PATH{\\\\srv\\a//b}")), _T("\\\\srv\\a\\b"), "a UNC name stays a Windows path" );
+    bench::CheckEq( f.Expand(_T("$TO_UNIX_PATH{a\\\\//b\\}")), _T("a/b/"), "a run of separators : one separator" );
+}
+
+//  ................................................................................................
+//  the $TO_ABSOLUTE_PATH{ } results hold for the working directory they were made in
+//  ................................................................................................
+void    CheckPathsCwd(Fixture & f)
+{
+    wxString const  cwd     =   wxGetCwd();
+    wxString        moved;
+    //  ............................................................................................
+    bench::Section("path functions cache");
+    f.Reset();
+
+    wxString const  first   =   f.Expand(_T("$TO_ABSOLUTE_PATH{rel/x}"));
+    f.Expand(_T("<$TO_ABSOLUTE_PATH{rel/x}>"));
+    bench::Check( ( f.Counters().pathMisses == 1 ) && ( f.Counters().pathHits == 1 ), "same cwd : computed once" );
+
+    wxSetWorkingDirectory(_T("/"));
+    moved = f.Expand(_T("$TO_ABSOLUTE_PATH{rel/x}"));
+    wxSetWorkingDirectory(cwd);
+    bench::Check( f.Counters().pathMisses == 2, "cwd changed : computed again" );
+    bench::Check( ( moved != first ) && moved.EndsWith(_T("rel/x")) && ! moved.StartsWith(cwd), "cwd changed : relative to the new cwd" );
+
+    bench::CheckEq( f.Expand(_T("$TO_ABSOLUTE_PATH{rel/x}")), first, "cwd back : the former result" );
+    bench::Check( f.Counters().pathMisses == 3, "cwd back : computed again" );
+}
+
+//  ................................................................................................
+//  the expansion profile, dumped as JSON
+//  ................................................................................................
+/// Minimal JSON reader : checks the syntax of a text and lists its members as "path:type", the
+/// elements of an array under "path[]" ( "macros[].count:number" ).
+class JsonShape
+{
+    public:
+        explicit JsonShape(std::string const & _i_text) : m_Text(_i_text), m_Pos(0), m_Paths(nullptr)   {   }
+
+        bool    Parse(std::set< std::string > & _o_paths)
+        {
+            m_Paths = &_o_paths;
+            m_Pos   = 0;
+            if ( ! Value(std::string()) )
+                return false;
+            Space();
+            return m_Pos == m_Text.size();
+        }
+
+    private:
+        void    Space()
+        {
+            while ( ( m_Pos < m_Text.size() ) && isspace( static_cast< unsigned char >( m_Text[m_Pos] ) ) )
+                ++m_Pos;
+        }
+
+        bool    Eat(char _i_c)
+        {
+            Space();
+            if ( ( m_Pos < m_Text.size() ) && ( m_Text[m_Pos] == _i_c ) )
+            {
+                ++m_Pos;
+                return true;
+            }
+            return false;
+        }
+
+        bool    Add(std::string const & _i_path, const char * _i_type)
+        {
+            m_Paths->insert(_i_path + ":" + _i_type);
+            return true;
+        }
+
+        bool    String(std::string & _o_text)
+        {
+            if ( ! Eat('"') )
+                return false;
+
+            _o_text.clear();
+            while ( m_Pos < m_Text.size() )
+            {
+                char c = m_Text[m_Pos++];
+
+                if ( c == '"' )
+                    return true;
+                if ( static_cast< unsigned char >( c ) < 0x20 )                                      // must be escaped
+                    return false;
+                if ( c == '\\' )
+                {
+                    if ( m_Pos >= m_Text.size() )
+                        return false;
+                    c = m_Text[m_Pos++];
+                    if ( c == 'u' )
+                    {
+                        if ( ( m_Pos + 4 > m_Text.size() ) || ( m_Text.find_first_not_of("0123456789abcdefABCDEF", m_Pos) < m_Pos + 4 ) )
+                            return false;
+                        m_Pos += 4;
+                        c = '?';
+                    }
+                    else if ( std::string("\"\\/bfnrt").find(c) == std::string::npos )
+                    {
+                        return false;
+                    }
+                }
+                _o_text.append(1u, c);
+            }
+            return false;
+        }
+
+        bool    Value(std::string const & _i_path)
+        {
+            std::string text;
+            //  ....................................................................................
+            Space();
+            if ( m_Pos >= m_Text.size() )
+                return false;
+
+            switch ( m_Text[m_Pos] )
+            {
+                case '{' :
+                {
+                    ++m_Pos;
+                    if ( ! Eat('}') )
+                    {
+                        do
+                        {
+                            if ( ! String(text) || ! Eat(':') || ! Value( _i_path.empty() ? text : _i_path + "." + text ) )
+                                return false;
+                        }
+                        while ( Eat(',') );
+
+                        if ( ! Eat('}') )
+                            return false;
+                    }
+                    return Add(_i_path, "object");
+                }
+                case '[' :
+                {
+                    ++m_Pos;
+                    if ( ! Eat(']') )
+                    {
+                        do
+                        {
+                            if ( ! Value(_i_path + "[]") )
+                                return false;
+                        }
+                        while ( Eat(',') );
+
+                        if ( ! Eat(']') )
+                            return false;
+                    }
+                    return Add(_i_path, "array");
+                }
+                case '"' :
+                    return String(text) && Add(_i_path, "string");
+            }
+
+            if ( m_Text.compare(m_Pos, 4, "true") == 0 )
+            {
+                m_Pos += 4;
+                return Add(_i_path, "boolean");
+            }
+            if ( m_Text.compare(m_Pos, 5, "false") == 0 )
+            {
+                m_Pos += 5;
+                return Add(_i_path, "boolean");
+            }
+
+            size_t end = m_Text.find_first_not_of("-+.eE0123456789", m_Pos);
+
+            if ( end == std::string::npos )
+                end = m_Text.size();
+            if ( ( end == m_Pos ) || ! ( isdigit( static_cast< unsigned char >( m_Text[end - 1] ) ) ) )
+                return false;
+            m_Pos = end;
+            return Add(_i_path, "number");
+        }
+
+        std::string const           &   m_Text;
+        size_t                          m_Pos;
+        std::set< std::string >     *   m_Paths;
+};
+
+void    CheckProfile(Fixture & f)
+{
+    static const char * const expected[] =
+    {
+        ":object"                   , "enabled:boolean"             , "evaluations:number"          ,
+        "constructs:array"          , "constructs[]:object"         , "constructs[].name:string"    ,
+        "constructs[].count:number" , "constructs[].us:number"      , "constructs[].chars:number"   ,
+        "macros:array"              , "macros[]:object"             , "macros[].name:string"        ,
+        "macros[].count:number"     , "macros[].us:number"          , "macros[].chars:number"       ,
+        "slowest_templates:array"   , "slowest_templates[]:object"  , "slowest_templates[].us:number",
+        "slowest_templates[].source:string"
+    };
+    wxString const              filename    =   wxFileName::GetTempDir() + wxFILE_SEP_PATH + _T("macros-checks-profile.json");
+    std::set< std::string >     paths;
+    std::set< std::string >     want        (expected, expected + sizeof(expected) / sizeof(expected[0]));
+    std::string                 json;
+    //  ............................................................................................
+    bench::Section("expansion profile");
+    f.Reset();
+
+    f.target->VarSet(_T("FOO"), _T("foo"), wxEmptyString, CompileOptionsBase::eVarActive);
+    f.Mm()->ProfileEnable(true);
+    f.Expand(_T("$(FOO) $if(1){a}{b} $TO_UNIX_PATH{a\\b}"));
+    f.Expand(_T("quote \" backslash \\ tab \t newline \n $(FOO)"));                                  // escaped by the dump
+    bench::Check( f.Mm()->ProfileDump(filename), "ProfileDump() writes the file" );
+    f.Mm()->ProfileEnable(false);
+
+    std::ifstream       in      ( (const char*)filename.utf8_str() );
+    std::ostringstream  text;
+    text << in.rdbuf();
+    json = text.str();
+    in.close();
+    std::remove( (const char*)filename.utf8_str() );
+
+    bench::Check( JsonShape(json).Parse(paths), "the dump is JSON" );
+    bench::Check( paths == want, "its members and their types" );
+    bench::Check( json.find("\"enabled\": true") != std::string::npos, "enabled : true" );
+    bench::Check( json.find("{ \"name\": \"FOO\", \"count\": 2,") != std::string::npos, "macros : FOO, expanded twice" );
+    bench::Check( json.find("{ \"name\": \"$if\", \"count\": 1,") != std::string::npos, "constructs : $if, once" );
+}
+
+} // namespace
+
+int main()
+{
+    wxInitializer   initializer;                                                                    // wxStandardPaths wants an app
+    Fixture         f;
+    //  ............................................................................................
+    CheckMerge(f);
+    CheckTemplatesLru(f);
+    CheckResults(f);
+    CheckVarsListener(f);
+    CheckCycles(f);
+    CheckEnv(f);
+    CheckBuiltins(f);
+    CheckLazySlots(f);
+    CheckIf(f);
+    CheckScripts(f);
+    CheckSeparators(f);
+    CheckPathsCwd(f);
+    CheckProfile(f);
+
+    printf("%d check(s) failed\n", bench::Failures());
+    return bench::Failures();
+}
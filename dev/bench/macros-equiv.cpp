@@ -0,0 +1,144 @@
+/*
+ *  dev/bench/macros-equiv.cpp
+ *
+ *  MacrosManager::ReplaceMacros() of each template of a corpus ( dev/bench/corpus/equiv.txt ),
+ *  in a few states of a small project : targets, var edits in each layer, no project. Prints one
+ *  line per template and state. dev/lx/checks.bash builds it against src/ and against src/ref/,
+ *  runs both on the corpus and compares their outputs : the new MacrosManager must expand like
+ *  the svn 11914 one. Only the old API of CompileOptionsBase ( SetVar(), UnsetVar() ) is used,
+ *  both builds have it.
+ *
+ *      macros-equiv <corpus>
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <wx/init.h>
+#include <wx/utils.h>
+
+#include "sdk_precomp.h"
+#include "manager.h"
+#include "projectmanager.h"
+#include "uservarmanager.h"
+#include "compilerfactory.h"
+#include "macrosmanager.h"
+
+namespace
+{
+
+bool    LoadCorpus(const char * _i_path, std::vector< wxString > & _o_lines)
+{
+    std::ifstream   in(_i_path);
+    std::string     line;
+    //  ............................................................................................
+    if ( ! in )
+        return false;
+
+    while ( std::getline(in, line) )
+    {
+        if ( ! line.empty() && ( line[line.size() - 1] == '\r' ) )
+            line.erase(line.size() - 1);
+        if ( line.empty() || ( line[0] == '#' ) )
+            continue;
+
+        wxString tpl = wxString::FromUTF8(line.c_str());
+        tpl.Replace(_T("@NL@"), _T("\n"));
+        _o_lines.push_back(tpl);
+    }
+
+    return ! _o_lines.empty();
+}
+
+/// Print the expansion of each template by the target _i_target, after a RecalcVars() : the svn
+/// 11914 MacrosManager recalculates only when the project or the target changes.
+void    Dump(const char * _i_state, std::vector< wxString > const & _i_corpus, cbProject * _i_project, ProjectBuildTarget * _i_target)
+{
+    MacrosManager * mm = Manager::Get()->GetMacrosManager();
+    //  ............................................................................................
+    Manager::Get()->GetProjectManager()->m_Project = _i_project;
+    mm->RecalcVars(_i_project, nullptr, _i_target);
+
+    for ( size_t i = 0 ; i < _i_corpus.size() ; i++ )
+    {
+        wxString    in  =   _i_corpus[i];
+        wxString    out =   _i_corpus[i];
+
+        mm->ReplaceMacros(out, _i_target);
+        in .Replace(_T("\n"), _T("@NL@"));
+        out.Replace(_T("\n"), _T("@NL@"));
+        printf("%-28s | %s => [%s]\n", _i_state, (const char*)in.utf8_str(), (const char*)out.utf8_str());
+    }
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    wxInitializer               initializer;                                                        // wxStandardPaths wants an app
+    std::vector< wxString >     corpus;
+    cbProject                   project;
+    Compiler                *   compiler    =   CompilerFactory::GetCompiler(_T("gcc"));
+    ProjectBuildTarget      *   debug;
+    ProjectBuildTarget      *   release;
+    std::map< wxString, wxString > & globals = Manager::Get()->GetUserVariableManager()->m_Vars;
+    //  ............................................................................................
+    if ( argc < 2 )
+    {
+        fprintf(stderr, "usage : %s <corpus>\n", argv[0]);
+        return 1;
+    }
+    if ( ! LoadCorpus(argv[1], corpus) )
+    {
+        fprintf(stderr, "> no template in the corpus %s\n", argv[1]);
+        return 1;
+    }
+    //  ............................................................................................
+    //  the project, its targets, their vars
+    project.m_Title     =   _T("proj");
+    project.m_Filename  =   _T("/src/proj/proj.cbp");
+    project.AddFile(_T("main.cpp"));
+    debug               =   project.AddBuildTarget(_T("Debug"));
+    release             =   project.AddBuildTarget(_T("Release"));
+
+    compiler->SetVar(_T("COMPONLY")     , _T("comp"));
+    compiler->SetVar(_T("SHADOW")       , _T("from-compiler"));
+    project.SetVar  (_T("PROJONLY")     , _T("projv"));
+    project.SetVar  (_T("SHADOW")       , _T("from-project"));
+    project.SetVar  (_T("FOO")          , _T("pfoo"));
+    debug  ->SetVar (_T("FOO")          , _T("foo"));
+    debug  ->SetVar (_T("TARGETONLY")   , _T("dbg"));
+    debug  ->SetVar (_T("SHADOW")       , _T("from-debug"));
+    debug  ->SetVar (_T("RECUR")        , _T("$(FOO)x"));
+    debug  ->SetVar (_T("REC1")         , _T("$(FOO)/sub"));
+    debug  ->SetVar (_T("DOSREC")       , _T("%FOO%"));
+    debug  ->SetVar (_T("QV")           , _T("\"quoted $$\""));
+    debug  ->SetVar (_T("TRAILDOLLAR")  , _T("t$"));
+    debug  ->SetVar (_T("EMPTYV")       , wxEmptyString);
+    release->SetVar (_T("FOO")          , _T("rfoo"));
+
+    globals[_T("GLOBAL")]           =   _T("g\\v");
+    globals[_T("GLOBAL.INCLUDE")]   =   _T("/inc");
+    wxSetEnv(_T("EQ_ENV"), _T("envv"));
+    //  ............................................................................................
+    //  the states
+    Dump("debug"                        , corpus, &project, debug   );
+    Dump("release"                      , corpus, &project, release );
+    Dump("active target"                , corpus, &project, nullptr );
+
+    debug  ->SetVar(_T("FOO"), _T("foo2"));
+    Dump("debug, target var edited"     , corpus, &project, debug   );
+    release->UnsetVar(_T("FOO"));
+    Dump("release, target var unset"    , corpus, &project, release );
+    project.SetVar(_T("PROJONLY"), _T("projv2"));
+    Dump("release, project var edited"  , corpus, &project, release );
+    compiler->SetVar(_T("COMPONLY"), _T("comp2"));
+    Dump("debug, compiler var edited"   , corpus, &project, debug   );
+
+    Dump("no project"                   , corpus, nullptr , nullptr );
+
+    return 0;
+}
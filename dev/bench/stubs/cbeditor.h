@@ -0,0 +1,15 @@
+#ifndef BENCH_STUBS_CBEDITOR_H
+#define BENCH_STUBS_CBEDITOR_H
+
+#include "editorbase.h"
+#include "cbstyledtextctrl.h"
+
+class cbEditor : public EditorBase
+{
+    public:
+        cbStyledTextCtrl *  GetControl()    { return &m_Control;    }
+
+        cbStyledTextCtrl    m_Control;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef BENCH_STUBS_CBPROJECT_H
+#define BENCH_STUBS_CBPROJECT_H
+
+#include <list>
+#include <vector>
+
+#include "compiletargetbase.h"
+
+class cbProject;
+
+class ProjectFile
+{
+    public:
+        wxString    relativeFilename;
+};
+typedef std::list< ProjectFile * > FilesList;
+
+class ProjectBuildTarget : public CompileTargetBase
+{
+    public:
+        ProjectBuildTarget() : m_Project(nullptr)   {   }
+
+        cbProject * GetParentProject() const        { return m_Project; }
+
+        cbProject * m_Project;
+};
+
+class cbProject : public CompileTargetBase
+{
+    public:
+        cbProject() : m_Compiling(nullptr)          {   }
+        ~cbProject()
+        {
+            for ( size_t i = 0 ; i < m_Targets.size() ; i++ )
+                delete m_Targets[i];
+            for ( FilesList::iterator it = m_Files.begin() ; it != m_Files.end() ; ++it )
+                delete *it;
+        }
+
+        ProjectBuildTarget *    AddBuildTarget(const wxString& title)
+        {
+            ProjectBuildTarget * t = new ProjectBuildTarget;
+
+            t->m_Project        = this;
+            t->m_Title          = title;
+            t->m_Filename       = m_Filename;
+            t->m_OutputFilename = _T("bin/") + title + _T("/") + m_Title;
+            m_Targets.push_back(t);
+            if ( m_ActiveTarget.IsEmpty() )
+                m_ActiveTarget = title;
+            return t;
+        }
+        void                    AddFile(const wxString& relative)
+        {
+            ProjectFile * f = new ProjectFile;
+
+            f->relativeFilename = relative;
+            m_Files.push_back(f);
+        }
+
+        void                    SetModified(bool modified)                                          // as the sdk's : passed down to the targets
+        {
+            CompileTargetBase::SetModified(modified);
+            for ( size_t i = 0 ; i < m_Targets.size() ; i++ )
+                m_Targets[i]->SetModified(modified);
+        }
+
+        int                     GetBuildTargetsCount        () const    { return static_cast< int >( m_Targets.size() );                            }
+        ProjectBuildTarget *    GetBuildTarget              (int index) const
+        {
+            return ( ( index >= 0 ) && ( index < GetBuildTargetsCount() ) ) ? m_Targets[index] : nullptr;
+        }
+        ProjectBuildTarget *    GetBuildTarget              (const wxString& title) const
+        {
+            for ( size_t i = 0 ; i < m_Targets.size() ; i++ )
+                if ( m_Targets[i]->GetTitle() == title )
+                    return m_Targets[i];
+            return nullptr;
+        }
+        const wxString&         GetActiveBuildTarget        () const    { return m_ActiveTarget;    }
+        ProjectBuildTarget *    GetCurrentlyCompilingTarget () const    { return m_Compiling;       }
+        const FilesList&        GetFilesList                () const    { return m_Files;           }
+        wxString                GetCommonTopLevelPath       () const    { return GetBasePath();     }
+        wxString                GetMakefile                 () const    { return _T("Makefile");    }
+
+        std::vector< ProjectBuildTarget * > m_Targets;
+        FilesList                           m_Files;
+        wxString                            m_ActiveTarget;
+        ProjectBuildTarget *                m_Compiling;
+};
+
+#endif
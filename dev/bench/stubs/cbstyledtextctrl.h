@@ -0,0 +1,18 @@
+#ifndef BENCH_STUBS_CBSTYLEDTEXTCTRL_H
+#define BENCH_STUBS_CBSTYLEDTEXTCTRL_H
+
+#include <wx/string.h>
+
+class cbStyledTextCtrl
+{
+    public:
+        int         GetCurrentLine      () const            { return 0;                 }
+        int         GetCurrentPos       () const            { return 0;                 }
+        int         GetColumn           (int) const         { return 0;                 }
+        wxString    GetSelectedText     () const            { return wxEmptyString;     }
+        int         WordStartPosition   (int, bool) const   { return 0;                 }
+        int         WordEndPosition     (int, bool) const   { return 0;                 }
+        wxString    GetTextRange        (int, int) const    { return wxEmptyString;     }
+};
+
+#endif
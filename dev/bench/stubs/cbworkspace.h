@@ -0,0 +1,13 @@
+#ifndef BENCH_STUBS_CBWORKSPACE_H
+#define BENCH_STUBS_CBWORKSPACE_H
+
+#include <wx/string.h>
+
+class cbWorkspace
+{
+    public:
+        wxString    GetFilename () const    { return _T("/work/bench.workspace");   }
+        wxString    GetTitle    () const    { return _T("bench");                   }
+};
+
+#endif
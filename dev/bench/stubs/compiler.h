@@ -0,0 +1,32 @@
+#ifndef BENCH_STUBS_COMPILER_H
+#define BENCH_STUBS_COMPILER_H
+
+#include "compileoptionsbase.h"
+
+struct CompilerPrograms
+{
+    wxString C;
+    wxString CPP;
+    wxString LD;
+    wxString LIB;
+};
+
+class Compiler : public CompileOptionsBase
+{
+    public:
+        Compiler() : m_MasterPath(_T("/usr"))
+        {
+            m_Programs.C    = _T("gcc");
+            m_Programs.CPP  = _T("g++");
+            m_Programs.LD   = _T("g++");
+            m_Programs.LIB  = _T("ar");
+        }
+
+        const CompilerPrograms& GetPrograms     () const    { return m_Programs;    }
+        const wxString&         GetMasterPath   () const    { return m_MasterPath;  }
+
+        CompilerPrograms    m_Programs;
+        wxString            m_MasterPath;
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef BENCH_STUBS_COMPILERFACTORY_H
+#define BENCH_STUBS_COMPILERFACTORY_H
+
+#include "compiler.h"
+
+/// One compiler, "gcc".
+class CompilerFactory
+{
+    public:
+        static Compiler *   GetCompiler(const wxString& id)    { return ( id == _T("gcc") ) ? &s_Compiler : nullptr;   }
+
+        static Compiler     s_Compiler;
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef BENCH_STUBS_COMPILETARGETBASE_H
+#define BENCH_STUBS_COMPILETARGETBASE_H
+
+#include "compileoptionsbase.h"
+
+class CompileTargetBase : public CompileOptionsBase
+{
+    public:
+        CompileTargetBase() : m_CompilerID(_T("gcc")), m_ObjectOutput(_T("obj/"))      {   }
+
+        const wxString& GetTitle                () const    { return m_Title;                                                       }
+        void            SetTitle                (const wxString& title) { m_Title = title; SetModified(true);                       }
+        const wxString& GetFilename             () const    { return m_Filename;                                                    }
+        wxString        GetBasePath             () const    { return wxFileName(m_Filename).GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR); }
+        wxString        GetOutputFilename       () const    { return m_OutputFilename;                                              }
+        const wxString& GetCompilerID           () const    { return m_CompilerID;                                                  }
+        wxString        GetObjectOutput         () const    { return m_ObjectOutput;                                                }
+        wxString        GetExecutionParameters  () const    { return wxEmptyString;                                                 }
+
+        wxString    m_Title;
+        wxString    m_Filename;
+        wxString    m_OutputFilename;
+        wxString    m_CompilerID;
+        wxString    m_ObjectOutput;
+};
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef BENCH_STUBS_CONFIGMANAGER_H
+#define BENCH_STUBS_CONFIGMANAGER_H
+
+#include <wx/string.h>
+#include <wx/filename.h>
+
+class ConfigManager
+{
+    public:
+        static wxString GetExecutableFolder ()                      { return _T("/opt/codeblocks/bin");                 }
+        static wxString GetPluginsFolder    (bool = true)           { return _T("/opt/codeblocks/share/plugins");       }
+        static wxString GetDataFolder       (bool = true)           { return _T("/opt/codeblocks/share/codeblocks");    }
+        static wxString GetConfigFolder     ()                      { return wxFileName::GetTempDir();                  }
+};
+
+#endif
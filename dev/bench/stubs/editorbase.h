@@ -0,0 +1,17 @@
+#ifndef BENCH_STUBS_EDITORBASE_H
+#define BENCH_STUBS_EDITORBASE_H
+
+#include <wx/string.h>
+
+class EditorBase
+{
+    public:
+        virtual ~EditorBase()   {   }
+
+        const wxString& GetFilename     () const    { return m_Filename;    }
+        bool            IsBuiltinEditor () const    { return true;          }
+
+        wxString    m_Filename;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef BENCH_STUBS_EDITORMANAGER_H
+#define BENCH_STUBS_EDITORMANAGER_H
+
+#include "cbeditor.h"
+
+/// No editor is open : the ACTIVE_EDITOR_* macros are empty.
+class EditorManager
+{
+    public:
+        EditorBase  *   GetActiveEditor         ()  { return nullptr;   }
+        cbEditor    *   GetBuiltinActiveEditor  ()  { return nullptr;   }
+};
+
+#endif
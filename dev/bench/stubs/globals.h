@@ -0,0 +1,76 @@
+#ifndef BENCH_STUBS_GLOBALS_H
+#define BENCH_STUBS_GLOBALS_H
+
+#include <wx/string.h>
+#include <wx/filename.h>
+#include <cstdint>
+#include <cstdio>
+
+#include "settings.h"
+
+enum SupportedPlatforms
+{
+    spMac       = 0x01,
+    spUnix      = 0x02,
+    spWindows   = 0x04,
+    spAll       = 0xff
+};
+
+namespace platform
+{
+#ifdef __WXMSW__
+    const bool windows  = true;
+#else
+    const bool windows  = false;
+#endif
+#ifdef __WXMAC__
+    const bool macosx   = true;
+#else
+    const bool macosx   = false;
+#endif
+    const bool Unix     = ! windows;
+}
+
+/// Same as C::B globals.cpp
+inline wxString UnixFilename(const wxString& filename, wxPathFormat format = wxPATH_NATIVE)
+{
+    wxString result = filename;
+
+    // Unc-names always override platform specific settings otherwise they become corrupted
+    bool unc_name = result.StartsWith(_T("\\\\"));
+
+    if ( ( format == wxPATH_WIN ) || ( ( format == wxPATH_NATIVE ) && platform::windows ) || unc_name )
+    {
+        while (result.Replace(_T("/"), _T("\\")))
+            ;
+        while (result.Replace(_T("\\\\"), _T("\\")))
+            ;
+
+        if (unc_name)
+            result = _T("\\") + result;
+    }
+    else
+    {
+        while (result.Replace(_T("\\"), _T("/")))
+            ;
+        while (result.Replace(_T("//"), _T("/")))
+            ;
+    }
+
+    return result;
+}
+
+inline void QuoteStringIfNeeded(wxString& str)
+{
+    if ( ( str.find_first_of(_T(" \t")) != wxString::npos ) && ! ( str.StartsWith(_T("\"")) && str.EndsWith(_T("\"")) ) )
+        str = _T("\"") + str + _T("\"");
+}
+
+/// No dialog : the message goes to stderr.
+inline int cbMessageBox(const wxString& message, const wxString& caption = wxEmptyString, int = 0)
+{
+    fprintf(stderr, "%s : %s\n", (const char*)caption.mb_str(), (const char*)message.mb_str());
+    return 0;
+}
+
+#endif
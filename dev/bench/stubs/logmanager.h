@@ -0,0 +1,26 @@
+#ifndef BENCH_STUBS_LOGMANAGER_H
+#define BENCH_STUBS_LOGMANAGER_H
+
+#include <cstdio>
+#include <wx/string.h>
+
+/// Warnings go to stderr and are counted, the rest is dropped.
+class LogManager
+{
+    public:
+        LogManager() : m_Warnings(0)    {   }
+
+        void    Log         (const wxString &)          {   }
+        void    DebugLog    (const wxString &)          {   }
+        void    LogWarning  (const wxString & msg)
+        {
+            fprintf(stderr, "%s\n", (const char*)msg.mb_str());
+            ++m_Warnings;
+            m_LastWarning = msg;
+        }
+
+        int         m_Warnings;
+        wxString    m_LastWarning;
+};
+
+#endif
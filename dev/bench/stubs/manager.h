@@ -0,0 +1,62 @@
+#ifndef BENCH_STUBS_MANAGER_H
+#define BENCH_STUBS_MANAGER_H
+
+#include <wx/string.h>
+
+#include "settings.h"
+#include "sdk_events.h"
+
+class ProjectManager;
+class EditorManager;
+class ScriptingManager;
+class UserVariableManager;
+class MacrosManager;
+class ConfigManager;
+class LogManager;
+class wxFrame;
+
+template <class MgrT> class Mgr
+{
+        static MgrT *   instance;
+        static bool     isShutdown;
+
+    protected:
+        Mgr()           {   }
+        virtual ~Mgr()  {   }
+
+    public:
+        static bool     Valid() { return instance; }
+        static MgrT *   Get()
+        {
+            if ( ! instance && ! isShutdown )
+                instance = new MgrT();
+            return instance;
+        }
+        static void     Free()
+        {
+            isShutdown = true;
+            delete instance;
+            instance = nullptr;
+        }
+};
+
+/// The managers are plain objects owned by the stubs ( stubs.cpp ).
+class Manager
+{
+    public:
+        static Manager *        Get();
+
+        ProjectManager      *   GetProjectManager       () const;
+        EditorManager       *   GetEditorManager        () const;
+        ScriptingManager    *   GetScriptingManager     () const;
+        UserVariableManager *   GetUserVariableManager  () const;
+        MacrosManager       *   GetMacrosManager        () const;
+        LogManager          *   GetLogManager           () const;
+        wxFrame             *   GetAppFrame             () const    { return nullptr;   }
+
+        /// No event is ever sent : the functor is dropped.
+        template < class Functor > void RegisterEventSink(int, Functor * functor)   { delete functor;   }
+        void                    RemoveAllEventSinksFor  (void *)    {   }
+};
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef BENCH_STUBS_PROJECTMANAGER_H
+#define BENCH_STUBS_PROJECTMANAGER_H
+
+#include "cbproject.h"
+#include "cbworkspace.h"
+
+class ProjectManager
+{
+    public:
+        ProjectManager() : m_Project(nullptr), m_Workspace(nullptr)     {   }
+
+        cbProject   *   GetActiveProject()  { return m_Project;     }
+        cbWorkspace *   GetWorkspace    ()  { return m_Workspace;   }
+
+        cbProject   *   m_Project;
+        cbWorkspace *   m_Workspace;
+};
+
+#endif
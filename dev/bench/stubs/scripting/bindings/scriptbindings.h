@@ -0,0 +1,3 @@
+#ifndef BENCH_STUBS_SCRIPTBINDINGS_H
+#define BENCH_STUBS_SCRIPTBINDINGS_H
+#endif
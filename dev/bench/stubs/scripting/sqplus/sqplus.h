@@ -0,0 +1,59 @@
+#ifndef BENCH_STUBS_SQPLUS_H
+#define BENCH_STUBS_SQPLUS_H
+
+#include <wx/string.h>
+
+/** No Squirrel VM in the benchmarks : a snippet "compiles" into its own text, and running it
+  * prints that text through the print function. [[script]] still returns its source, through
+  * the closures cache of MacrosManager::RunScript(). A snippet starting with "throw" fails
+  * when run.
+  */
+typedef char            SQChar;
+typedef struct SQVM *   HSQUIRRELVM;
+typedef void (*SQPRINTFUNCTION)(HSQUIRRELVM, const SQChar *, ...);
+
+namespace bench
+{
+inline SQPRINTFUNCTION & PrintFunc()    { static SQPRINTFUNCTION f = nullptr; return f; }
+}
+
+inline SQPRINTFUNCTION  sq_getprintfunc (HSQUIRRELVM)                           { return bench::PrintFunc();    }
+inline void             sq_setprintfunc (HSQUIRRELVM, SQPRINTFUNCTION func)     { bench::PrintFunc() = func;    }
+
+class SquirrelError
+{
+    public:
+        SquirrelError(const SQChar * s) : desc(s)   {   }
+
+        const SQChar *  desc;
+};
+
+class SquirrelObject
+{
+    public:
+        wxString    m_Text;
+};
+
+class SquirrelVM
+{
+    public:
+        static HSQUIRRELVM      GetVMPtr        ()                                          { return nullptr;   }
+        static SquirrelObject   CompileBuffer   (const SQChar * s, const SQChar * = nullptr)
+        {
+            SquirrelObject o;
+            o.m_Text = wxString::FromUTF8(s);
+            return o;
+        }
+        static void             RunScript       (SquirrelObject const & o)
+        {
+            if ( o.m_Text.StartsWith(_T("throw")) )
+                throw SquirrelError("the snippet throws");
+            if ( bench::PrintFunc() )
+                bench::PrintFunc()(nullptr, "%s", (const char *)o.m_Text.utf8_str());
+        }
+};
+
+inline wxCharBuffer cbU2C(const wxString& str)  { return str.utf8_str();            }
+inline wxString     cbC2U(const char * str)      { return wxString::FromUTF8(str);   }
+
+#endif
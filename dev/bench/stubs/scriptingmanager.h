@@ -0,0 +1,21 @@
+#ifndef BENCH_STUBS_SCRIPTINGMANAGER_H
+#define BENCH_STUBS_SCRIPTINGMANAGER_H
+
+#include <wx/string.h>
+
+class SquirrelError;
+
+/// [[script]] returns its source : no Squirrel VM in the benchmarks. The calls are counted.
+class ScriptingManager
+{
+    public:
+        ScriptingManager() : m_Loads(0), m_Errors(0)   {   }
+
+        wxString    LoadBufferRedirectOutput(const wxString& script)                { ++m_Loads;    return script;  }
+        bool        DisplayErrors           (SquirrelError* = 0, bool = true)           { ++m_Errors;   return true;    }
+
+        int         m_Loads;                                                                        //!< LoadBufferRedirectOutput() calls
+        int         m_Errors;                                                                       //!< DisplayErrors() calls
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef BENCH_STUBS_SDK_EVENTS_H
+#define BENCH_STUBS_SDK_EVENTS_H
+
+/// The events MacrosManager registers for ; nothing is ever sent in the benchmarks.
+class CodeBlocksEvent
+{
+};
+
+enum
+{
+    cbEVT_COMPILER_STARTED      =   1,
+    cbEVT_COMPILER_FINISHED     =   2
+};
+
+template < class ClassType, typename EventType > class cbEventFunctor
+{
+    public:
+        typedef void (ClassType::*Member)(EventType &);
+
+        cbEventFunctor(ClassType * object, Member member) : m_Object(object), m_Member(member) {   }
+
+        ClassType   *   m_Object;
+        Member          m_Member;
+};
+
+#endif
@@ -0,0 +1,23 @@
+/*
+ *  dev/bench/stubs/sdk_precomp.h
+ *
+ *  Stand-ins for the C::B sdk headers included by macrosmanager.cpp and compileoptionsbase.cpp,
+ *  so that the benchmarks build these two files ( patched ones from src/, or the former ones
+ *  from src/ref/ ) with wxBase only : no app, no frame, no plugin. Each stub only provides what
+ *  these two files call ; the benchmark fills the stub objects directly.
+ */
+
+#ifndef BENCH_STUBS_SDK_PRECOMP_H
+#define BENCH_STUBS_SDK_PRECOMP_H
+
+#include <cassert>
+
+#include <wx/string.h>
+#include <wx/arrstr.h>
+#include <wx/intl.h>
+#include <wx/datetime.h>
+#include <wx/filename.h>
+#include <wx/regex.h>
+#include <wx/utils.h>
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef BENCH_STUBS_SETTINGS_H
+#define BENCH_STUBS_SETTINGS_H
+
+#define DLLIMPORT
+#define EVTIMPORT
+#define cb_unused
+
+#endif
@@ -0,0 +1,34 @@
+/*
+ *  dev/bench/stubs/stubs.cpp
+ *
+ *  The managers of the stubbed sdk.
+ */
+
+#include "sdk_precomp.h"
+#include "manager.h"
+#include "projectmanager.h"
+#include "editormanager.h"
+#include "scriptingmanager.h"
+#include "uservarmanager.h"
+#include "compilerfactory.h"
+#include "macrosmanager.h"
+#include "logmanager.h"
+
+namespace
+{
+ProjectManager      s_ProjectManager;
+EditorManager       s_EditorManager;
+ScriptingManager    s_ScriptingManager;
+UserVariableManager s_UserVariableManager;
+LogManager          s_LogManager;
+}
+
+Compiler CompilerFactory::s_Compiler;
+
+Manager *               Manager::Get                    ()          { static Manager m; return &m;      }
+ProjectManager      *   Manager::GetProjectManager      () const    { return &s_ProjectManager;         }
+EditorManager       *   Manager::GetEditorManager       () const    { return &s_EditorManager;          }
+ScriptingManager    *   Manager::GetScriptingManager    () const    { return &s_ScriptingManager;       }
+UserVariableManager *   Manager::GetUserVariableManager () const    { return &s_UserVariableManager;    }
+MacrosManager       *   Manager::GetMacrosManager       () const    { return MacrosManager::Get();      }
+LogManager          *   Manager::GetLogManager          () const    { return &s_LogManager;             }
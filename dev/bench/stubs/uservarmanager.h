@@ -0,0 +1,20 @@
+#ifndef BENCH_STUBS_USERVARMANAGER_H
+#define BENCH_STUBS_USERVARMANAGER_H
+
+#include <map>
+#include <wx/string.h>
+
+/// Global user vars, by upper-cased name without '#' ; "#name.member" is a name as a whole.
+class UserVariableManager
+{
+    public:
+        wxString Replace(const wxString& variable)
+        {
+            std::map< wxString, wxString >::const_iterator it = m_Vars.find( variable.Mid(1).Upper() );
+            return ( it != m_Vars.end() ) ? it->second : wxString();
+        }
+
+        std::map< wxString, wxString >  m_Vars;
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef BENCH_STUBS_WX_FRAME_H
+#define BENCH_STUBS_WX_FRAME_H
+
+#include <wx/event.h>
+
+/// wxCore stand-in : Manager::GetAppFrame() returns none in the benchmarks.
+class wxFrame : public wxEvtHandler
+{
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef BENCH_STUBS_WX_MENU_H
+#define BENCH_STUBS_WX_MENU_H
+
+#include <wx/string.h>
+
+/// wxCore stand-ins : the benchmarks link wxBase only, and have no menu bar.
+class wxMenu
+{
+    public:
+        void    AppendSeparator ()                                                  {   }
+        void    AppendCheckItem (int, const wxString&, const wxString& = wxEmptyString) {   }
+        void    Append          (int, const wxString&, const wxString& = wxEmptyString) {   }
+        void    Check           (int, bool)                                         {   }
+        bool    Destroy         (int)                                               { return false;         }
+};
+
+class wxMenuBar
+{
+    public:
+        int         FindMenu    (const wxString&) const                             { return wxNOT_FOUND;   }
+        wxMenu  *   GetMenu     (size_t) const                                      { return nullptr;       }
+        void    *   FindItem    (int, wxMenu ** menu = nullptr) const               { if ( menu ) *menu = nullptr; return nullptr; }
+};
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ *  dev/bench/vars-checks.cpp
+ *
+ *  Behaviour checks of the custom vars of CompileOptionsBase and of their CustomVarStore ; the
+ *  exit code is the number of failed checks. Built with the stubbed sdk of dev/bench/stubs by
+ *  dev/lx/checks.bash.
+ */
+
+#include <cstdio>
+
+#include "sdk_precomp.h"
+#include "compileoptionsbase.h"
+
+#include "checks.h"
+
+namespace
+{
+
+size_t  Count(CompileOptionsBase const & _i_base, int _i_flags)
+{
+    size_t n = 0;
+    //  ............................................................................................
+    for ( CustomVarEntry const & e : _i_base.VarEnum(_i_flags) )
+    {
+        (void)e;
+        n++;
+    }
+
+    return n;
+}
+
+bool    Enumerated(CompileOptionsBase const & _i_base, int _i_flags, wxString const & _i_key)
+{
+    for ( CustomVarEntry const & e : _i_base.VarEnum(_i_flags) )
+    {
+        if ( e.key == _i_key )
+            return true;
+    }
+
+    return false;
+}
+
+//  ................................................................................................
+//  the active and inactive stores : VarGet(), VarEnum() flags, HasVar(), UnsetAllVars()
+//  ................................................................................................
+void    CheckStores()
+{
+    CompileOptionsBase  b;
+    CustomVar           cv  =   { _T("untouched"), wxEmptyString, 0 };
+    unsigned long       g;
+    //  ............................................................................................
+    bench::Section("stores");
+
+    b.VarSet(_T("A"), _T("a"), _T("comment of A"), CompileOptionsBase::eVarActive);
+    b.VarSet(_T("I"), _T("i"), wxEmptyString, CompileOptionsBase::eVarInactive);
+    b.VarSet(_T("Z"), _T("z"), wxEmptyString, 0);
+
+    bench::Check( ! b.VarGet(_T("MISSING"), cv), "VarGet() of a missing var returns false" );
+    bench::Check( cv.value == _T("untouched"), "VarGet() of a missing var leaves the out param" );
+    bench::Check( b.VarGet(_T("A"), cv) && ( cv.value == _T("a") ) && ( cv.comment == _T("comment of A") ), "VarGet() of a var returns it" );
+
+    bench::Check( Enumerated(b, CompileOptionsBase::eVarActive, _T("A")), "active var enumerated under eVarActive" );
+    bench::Check( ! Enumerated(b, CompileOptionsBase::eVarActive, _T("I")), "inactive var not enumerated under eVarActive" );
+    bench::Check( ! Enumerated(b, CompileOptionsBase::eVarActive, _T("Z")), "flags == 0 var not enumerated under eVarActive" );
+    bench::Check( Enumerated(b, CompileOptionsBase::eVarInactive, _T("Z")), "flags == 0 var enumerated under eVarInactive" );
+    bench::Check( Count(b, CompileOptionsBase::eVarAll) == 3, "eVarAll enumerates every var" );
+
+    bench::Check( b.HasVar(_T("A")) && ! b.HasVar(_T("I")) && ! b.HasVar(_T("Z")), "HasVar() sees active vars only" );
+
+    g = b.GetGeneration();
+    b.UnsetAllVars();
+    bench::Check( b.GetGeneration() == g + 1, "UnsetAllVars() moves the generation once" );
+    bench::Check( ! b.VarHas(_T("A")) && b.VarHas(_T("I")) && b.VarHas(_T("Z")), "UnsetAllVars() unsets active vars only" );
+
+    g = b.GetGeneration();
+    b.UnsetAllVars();
+    bench::Check( b.GetGeneration() == g, "UnsetAllVars() without active var does not move the generation" );
+
+    b.VarSet(_T("A"), _T("a"), wxEmptyString, CompileOptionsBase::eVarActive);
+    g = b.GetVarsGeneration();
+    b.VarUnsetAll();
+    bench::Check( Count(b, CompileOptionsBase::eVarAll) == 0, "VarUnsetAll() defaults to eVarAll ( was 0, a no-op )" );
+    bench::Check( b.GetVarsGeneration() == g + 1, "VarUnsetAll() moves the vars generation" );
+}
+
+//  ................................................................................................
+//  CustomVarStore : the keyUpper index is kept up to date by Insert(), Erase() and Clear()
+//  ................................................................................................
+/// Every key of the store is found, by Find() and by FindUpper() ; names never inserted are not.
+bool    StoreConsistent(CustomVarStore const & _i_store, int _i_names)
+{
+    for ( int n = 0 ; n < _i_names ; n++ )
+    {
+        wxString    upper   =   wxString::Format(_T("VAR_%d"), n);
+        bool        there   =   false;
+
+        for ( size_t i = 0 ; i != _i_store.Size() ; i++ )
+        {
+            if ( _i_store.Find( _i_store.At(i).key ) != static_cast< int >( i ) )
+                return false;
+            if ( _i_store.At(i).keyUpper == upper )
+                there = true;
+        }
+
+        int idx = _i_store.FindUpper(upper);
+        if ( there != ( idx != wxNOT_FOUND ) )
+            return false;
+        if ( ( idx != wxNOT_FOUND ) && ( _i_store.At(idx).keyUpper != upper ) )
+            return false;
+    }
+
+    return _i_store.FindUpper(_T("NOT_A_VAR")) == wxNOT_FOUND;
+}
+
+void    CheckUpperIndex()
+{
+    CustomVarStore      st;
+    CustomVar           cv          =   { _T("v"), wxEmptyString, CompileOptionsBase::eVarActive };
+    const int           names       =   64;
+    unsigned int        rnd         =   12345;
+    bool                ok          =   true;
+    //  ............................................................................................
+    bench::Section("keyUpper index");
+
+    st.Insert(_T("Abc"), cv);
+    bench::Check( st.FindUpper(_T("ABC")) == 0, "FindUpper() right after Insert()" );
+    st.Insert(_T("aBC"), cv);                                                                       // same keyUpper : the first one wins
+    bench::Check( st.FindUpper(_T("ABC")) == 0, "keys differing by case : the first one is found" );
+    st.Erase(_T("Abc"));
+    bench::Check( ( st.FindUpper(_T("ABC")) == 0 ) && ( st.At(0).key == _T("aBC") ), "erasing it : the other one is found" );
+    st.Erase(_T("aBC"));
+    bench::Check( st.FindUpper(_T("ABC")) == wxNOT_FOUND, "erasing both : not found" );
+    //  ............................................................................................
+    //  random inserts / erases of names in several cases, checked after each operation
+    for ( int op = 0 ; ok && ( op < 4000 ) ; op++ )
+    {
+        rnd = rnd * 1103515245u + 12345u;
+        int         n       =   ( rnd >> 8 ) % names;
+        wxString    key     =   wxString::Format( ( ( rnd >> 21 ) & 1 ) ? _T("Var_%d") : _T("var_%d"), n);
+
+        if ( ( rnd >> 20 ) & 1 )
+            key.MakeUpper();
+
+        if ( ( rnd >> 24 ) % 3 )
+            st.Insert(key, cv);
+        else
+            st.Erase(key);
+
+        if ( op == 3000 )
+            st.Clear();
+
+        ok = StoreConsistent(st, names);
+    }
+    bench::Check( ok, "random Insert() / Erase() / Clear() : Find() and FindUpper() agree" );
+}
+
+} // namespace
+
+int main()
+{
+    CheckStores();
+    CheckUpperIndex();
+
+    printf("%d check(s) failed\n", bench::Failures());
+    return bench::Failures();
+}
@@ -0,0 +1,121 @@
+/*
+ *  dev/bench/varstore-bench.cpp
+ *
+ *  CustomVars microbenchmark : lookup and full enumeration cost of the active vars, for the
+ *  CompileOptionsBase stores, compared to the former single CustomVarHash filtered on flags.
+ *  Each CompileOptionsBase holds N active and N inactive vars.
+ *
+ *  Built and run by dev/lx/bench-vars.bash
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <wx/string.h>
+#include <wx/hashmap.h>
+
+#include "compileoptionsbase.h"
+
+//  former layout : one hash map for active and inactive vars, filtered on CustomVar::flags
+WX_DECLARE_STRING_HASH_MAP(CustomVar, OldCustomVarHash);
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+double  ElapsedNs(Clock::time_point _i_start, size_t _i_ops)
+{
+    return std::chrono::duration< double, std::nano >( Clock::now() - _i_start ).count() / _i_ops;
+}
+
+bool    OldHasVar(OldCustomVarHash const & _i_vars, wxString const & _i_key)
+{
+    OldCustomVarHash::const_iterator it = _i_vars.find(_i_key);
+    return ( it != _i_vars.end() ) && ( it->second.flags & CompileOptionsBase::eVarActive );
+}
+
+size_t  OldEnumActive(OldCustomVarHash const & _i_vars)
+{
+    size_t len = 0;
+    for ( OldCustomVarHash::const_iterator it = _i_vars.begin() ; it != _i_vars.end() ; ++it )
+        if ( it->second.flags & CompileOptionsBase::eVarActive )
+            len += it->second.value.length();
+    return len;
+}
+
+size_t  NewEnumActive(CompileOptionsBase const & _i_base)
+{
+    size_t len = 0;
+    for ( CustomVarEntry const & e : _i_base.VarEnum(CompileOptionsBase::eVarActive) )
+        len += e.var.value.length();
+    return len;
+}
+
+void    Bench(size_t _i_count)
+{
+    CompileOptionsBase          base;
+    OldCustomVarHash            old;
+    std::vector< wxString >     keys;
+    size_t                      lookups     =   1000000;
+    size_t                      enums       =   ( 10000000 / _i_count ) + 1;
+    size_t                      found       =   0;
+    size_t                      len         =   0;
+    Clock::time_point           t0;
+    double                      oldLookup, newLookup, oldEnum, newEnum;
+    //  ............................................................................................
+    for ( size_t i = 0 ; i != _i_count ; i++ )
+    {
+        wxString    ka  = wxString::Format(_T("ACTIVE_VAR_%lu")  , (unsigned long)i);
+        wxString    ki  = wxString::Format(_T("INACTIVE_VAR_%lu"), (unsigned long)i);
+        wxString    val = wxString::Format(_T("/some/path/to/dir_%lu"), (unsigned long)i);
+        CustomVar   cva = { val, wxEmptyString, CompileOptionsBase::eVarActive   };
+        CustomVar   cvi = { val, wxEmptyString, CompileOptionsBase::eVarInactive };
+
+        base.VarSet(ka, val, wxEmptyString, CompileOptionsBase::eVarActive);
+        base.VarSet(ki, val, wxEmptyString, CompileOptionsBase::eVarInactive);
+        old[ka] = cva;
+        old[ki] = cvi;
+        keys.push_back(ka);
+    }
+    //  ............................................................................................
+    t0 = Clock::now();
+    for ( size_t i = 0 ; i != lookups ; i++ )
+        found += OldHasVar(old, keys[ i % _i_count ]) ? 1 : 0;
+    oldLookup = ElapsedNs(t0, lookups);
+
+    t0 = Clock::now();
+    for ( size_t i = 0 ; i != lookups ; i++ )
+        found += base.HasVar(keys[ i % _i_count ]) ? 1 : 0;
+    newLookup = ElapsedNs(t0, lookups);
+
+    t0 = Clock::now();
+    for ( size_t i = 0 ; i != enums ; i++ )
+        len += OldEnumActive(old);
+    oldEnum = ElapsedNs(t0, enums);
+
+    t0 = Clock::now();
+    for ( size_t i = 0 ; i != enums ; i++ )
+        len += NewEnumActive(base);
+    newEnum = ElapsedNs(t0, enums);
+    //  ............................................................................................
+    printf("%8lu | %12.1f %12.1f | %14.1f %14.1f | %lu %lu\n",
+           (unsigned long)_i_count, oldLookup, newLookup, oldEnum, newEnum,
+           (unsigned long)found, (unsigned long)len);                                               // printed so that nothing is optimized out
+}
+
+} // namespace
+
+int main()
+{
+    printf("  active |      lookup ( ns/op )     |  enumeration ( ns/walk )      |\n");
+    printf("    vars |     old hash       stores |       old hash         stores |\n");
+    printf("---------+---------------------------+-------------------------------+\n");
+
+    Bench(10);
+    Bench(1000);
+    Bench(100000);
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#!/bin/bash
+
+#   ################################################################################################
+#
+#   dev/lx/bench-allocs.bash
+#
+#   build the allocations check ( dev/bench/allocs-bounds.cpp ) against the patched src/, with
+#   the counting operator new of dev/bench/allocs.cpp ( BENCH_COUNT_ALLOCS ), and run it ; the
+#   C::B sdk is stubbed by dev/bench/stubs, only wxBase is needed. Fails when an operation of
+#   the custom vars or macros hot paths allocates more than its bound
+#
+#   $1  Ad  C::B project dir
+#
+#   ################################################################################################
+
+#   ------------------------------------------------------------------------------------------------
+#   Vars / options
+#   ------------------------------------------------------------------------------------------------
+AdCbProject="$1"
+#   ------------------------------------------------------------------------------------------------
+if [[ -z "${AdCbProject}" ]] ; then
+    echo "> Parameter #1 'AdCbProject' not defined."
+    exit 1
+fi
+
+AdCbProject="${AdCbProject%/}"                                                                      # C::B $(PROJECT_DIR) comes with a trailing '/'
+
+AdOut="${AdCbProject}/out/bench"
+AdBench="${AdCbProject}/dev/bench"
+
+echo "Summary:"                                                                                     # message
+echo "-------"
+echo "AdCbProject :${AdCbProject}"
+echo " "
+#   ------------------------------------------------------------------------------------------------
+#   Go
+#   ------------------------------------------------------------------------------------------------
+mkdir -p "${AdOut}"
+
+g++ -O2 -std=c++11 -DBENCH_COUNT_ALLOCS                                                             \
+    -I "${AdBench}/stubs"                                                                           \
+    $( wx-config --cxxflags base )                                                                  \
+    -I "${AdCbProject}/src"                                                                         \
+    "${AdBench}/allocs-bounds.cpp"                                                                  \
+    "${AdBench}/allocs.cpp"                                                                         \
+    "${AdBench}/stubs/stubs.cpp"                                                                    \
+    "${AdCbProject}/src/macrosmanager.cpp"                                                          \
+    "${AdCbProject}/src/compileoptionsbase.cpp"                                                     \
+    $( wx-config --libs base )                                                                      \
+    -o "${AdOut}/allocs-bounds"
+
+if [[ $(($?)) -ne 0 ]] ; then
+    echo "> build failed"
+    exit 1
+fi
+
+"${AdOut}/allocs-bounds"
+NuAbove=$(($?))
+if [[ ${NuAbove} -ne 0 ]] ; then
+    echo "> ${NuAbove} operation(s) above their bound"
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,78 @@
+#!/bin/bash
+
+#   ################################################################################################
+#
+#   dev/lx/bench-expand.bash
+#
+#   build the expansion benchmark ( dev/bench/expand-bench.cpp ) against the patched src/, and
+#   replay the corpus dev/bench/corpus/commands.txt on the grid of vars per target x targets ;
+#   the C::B sdk is stubbed by dev/bench/stubs, only wxBase is needed. One process per run, so
+#   that each first build starts with empty caches
+#
+#   $1  Ad  C::B project dir
+#
+#   ################################################################################################
+
+#   ------------------------------------------------------------------------------------------------
+#   Vars / options
+#   ------------------------------------------------------------------------------------------------
+AdCbProject="$1"
+#   ------------------------------------------------------------------------------------------------
+if [[ -z "${AdCbProject}" ]] ; then
+    echo "> Parameter #1 'AdCbProject' not defined."
+    exit 1
+fi
+
+AdCbProject="${AdCbProject%/}"                                                                      # C::B $(PROJECT_DIR) comes with a trailing '/'
+
+AdOut="${AdCbProject}/out/bench"
+AdBench="${AdCbProject}/dev/bench"
+FnCorpus="${AdBench}/corpus/commands.txt"
+
+NsVars="1 100 10000"
+NsTargets="1 20 200"
+NuVarsMax=200000                                                                                    # vars x targets : 10000 x 200 is left out
+
+echo "Summary:"                                                                                     # message
+echo "-------"
+echo "AdCbProject :${AdCbProject}"
+echo "FnCorpus    :${FnCorpus}"
+echo " "
+#   ------------------------------------------------------------------------------------------------
+#   Go
+#   ------------------------------------------------------------------------------------------------
+mkdir -p "${AdOut}"
+
+g++ -O2 -std=c++11 -DBENCH_COUNT_ALLOCS                                                             \
+    -I "${AdBench}/stubs"                                                                           \
+    $( wx-config --cxxflags base )                                                                  \
+    -I "${AdCbProject}/src"                                                                         \
+    "${AdBench}/expand-bench.cpp"                                                                   \
+    "${AdBench}/allocs.cpp"                                                                         \
+    "${AdBench}/stubs/stubs.cpp"                                                                    \
+    "${AdCbProject}/src/macrosmanager.cpp"                                                          \
+    "${AdCbProject}/src/compileoptionsbase.cpp"                                                     \
+    $( wx-config --libs base )                                                                      \
+    -o "${AdOut}/expand-bench"
+
+if [[ $(($?)) -ne 0 ]] ; then
+    echo "> build failed"
+    exit 1
+fi
+
+Header="-h"
+for NuVars in ${NsVars} ; do
+    for NuTargets in ${NsTargets} ; do
+        if [[ $(( NuVars * NuTargets )) -gt ${NuVarsMax} ]] ; then
+            continue
+        fi
+        "${AdOut}/expand-bench" "${FnCorpus}" ${NuVars} ${NuTargets} ${Header}
+        if [[ $(($?)) -ne 0 ]] ; then
+            echo "> run failed ( ${NuVars} vars, ${NuTargets} targets )"
+            exit 1
+        fi
+        Header=""
+    done
+done
+
+exit 0
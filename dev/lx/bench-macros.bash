@@ -0,0 +1,92 @@
+#!/bin/bash
+
+#   ################################################################################################
+#
+#   dev/lx/bench-macros.bash
+#
+#   build and run the ReplaceMacros() benchmark ( dev/bench/macros-bench.cpp ), once against the
+#   patched src/, once against the former src/ref/ ; the C::B sdk is stubbed by dev/bench/stubs,
+#   only wxBase is needed
+#
+#   $1  Ad  C::B project dir
+#
+#   ################################################################################################
+
+#   ------------------------------------------------------------------------------------------------
+#   Vars / options
+#   ------------------------------------------------------------------------------------------------
+AdCbProject="$1"
+#   ------------------------------------------------------------------------------------------------
+if [[ -z "${AdCbProject}" ]] ; then
+    echo "> Parameter #1 'AdCbProject' not defined."
+    exit 1
+fi
+
+AdCbProject="${AdCbProject%/}"                                                                      # C::B $(PROJECT_DIR) comes with a trailing '/'
+
+AdOut="${AdCbProject}/out/bench"
+AdBench="${AdCbProject}/dev/bench"
+
+echo "Summary:"                                                                                     # message
+echo "-------"
+echo "AdCbProject :${AdCbProject}"
+echo " "
+#   ------------------------------------------------------------------------------------------------
+#   Functions
+#   ------------------------------------------------------------------------------------------------
+#   $1  Ad  sources dir : src or src/ref
+#   $2  Fn  executable
+#   $3      extra compiler flags
+Build()
+{
+    g++ -O2 -std=c++11 $3                                                                           \
+        -I "${AdBench}/stubs"                                                                       \
+        $( wx-config --cxxflags base )                                                              \
+        -I "$1"                                                                                     \
+        "${AdBench}/macros-bench.cpp"                                                               \
+        "${AdBench}/stubs/stubs.cpp"                                                                \
+        "$1/macrosmanager.cpp"                                                                      \
+        "$1/compileoptionsbase.cpp"                                                                 \
+        $( wx-config --libs base )                                                                  \
+        -o "${AdOut}/$2"
+}
+#   ------------------------------------------------------------------------------------------------
+#   Go
+#   ------------------------------------------------------------------------------------------------
+mkdir -p "${AdOut}"
+
+Build "${AdCbProject}/src"      "macros-bench"
+if [[ $(($?)) -ne 0 ]] ; then
+    echo "> build failed ( src )"
+    exit 1
+fi
+
+Build "${AdCbProject}/src"      "macros-bench-scalar"   "-DMACROS_SCAN_SCALAR"
+if [[ $(($?)) -ne 0 ]] ; then
+    echo "> build failed ( src, scalar )"
+    exit 1
+fi
+
+Build "${AdCbProject}/src"      "macros-bench-avx2"     "-mavx2"
+if [[ $(($?)) -ne 0 ]] ; then
+    echo "> build failed ( src, avx2 )"
+    exit 1
+fi
+
+Build "${AdCbProject}/src/ref"  "macros-bench-ref"      "-DBENCH_REF"
+if [[ $(($?)) -ne 0 ]] ; then
+    echo "> build failed ( src/ref )"
+    exit 1
+fi
+
+"${AdOut}/macros-bench-scalar"
+echo " "
+"${AdOut}/macros-bench"
+echo " "
+if grep -q avx2 /proc/cpuinfo ; then
+    "${AdOut}/macros-bench-avx2"
+    echo " "
+fi
+"${AdOut}/macros-bench-ref"
+
+exit 0
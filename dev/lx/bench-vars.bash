@@ -0,0 +1,68 @@
+#!/bin/bash
+
+#   ################################################################################################
+#
+#   dev/lx/bench-vars.bash
+#
+#   build and run the CustomVars microbenchmark ( dev/bench/varstore-bench.cpp )
+#
+#   $1  Ad  C::B project dir
+#   $2  Ad  C::B trunk, patched with the CVars patches and built ( for libcodeblocks )
+#
+#   ################################################################################################
+
+#   ------------------------------------------------------------------------------------------------
+#   Vars / options
+#   ------------------------------------------------------------------------------------------------
+AdCbProject="$1"
+AdCbTrunk="$2"
+#   ------------------------------------------------------------------------------------------------
+if [[ -z "${AdCbProject}" ]] ; then
+    echo "> Parameter #1 'AdCbProject' not defined."
+    exit 1
+fi
+if [[ -z "${AdCbTrunk}" ]] ; then
+    echo "> Parameter #2 'AdCbTrunk' not defined : set the custom var CB_CVARS__CB_BENCH_TRUNK_DIR"
+    echo "  of the project to a C::B trunk patched with the CVars patches and built."
+    exit 1
+fi
+
+AdCbProject="${AdCbProject%/}"                                                                      # C::B $(PROJECT_DIR) comes with a trailing '/'
+AdCbTrunk="${AdCbTrunk%/}"
+
+AdOut="${AdCbProject}/out/bench"
+AdLib="${AdCbTrunk}/src/sdk/.libs"
+
+if [[ ! -d "${AdLib}" ]] ; then
+    echo "> '${AdLib}' not found : the C::B trunk '${AdCbTrunk}' is not built."
+    exit 1
+fi
+
+echo "Summary:"                                                                                     # message
+echo "-------"
+echo "AdCbProject :${AdCbProject}"
+echo "AdCbTrunk   :${AdCbTrunk}"
+echo " "
+#   ------------------------------------------------------------------------------------------------
+#   Go
+#   ------------------------------------------------------------------------------------------------
+mkdir -p "${AdOut}"
+
+g++ -O2 -std=c++11                                                                                  \
+    $( wx-config --cxxflags )                                                                       \
+    -I "${AdCbTrunk}/src/include"                                                                   \
+    -I "${AdCbTrunk}/src/include/tinyxml"                                                           \
+    -I "${AdCbTrunk}/src/sdk/wxscintilla/include"                                                   \
+    "${AdCbProject}/dev/bench/varstore-bench.cpp"                                                   \
+    -L "${AdLib}" -Wl,-rpath,"${AdLib}" -lcodeblocks                                                \
+    $( wx-config --libs )                                                                           \
+    -o "${AdOut}/varstore-bench"
+
+if [[ $(($?)) -ne 0 ]] ; then
+    echo "> build failed"
+    exit 1
+fi
+
+"${AdOut}/varstore-bench"
+
+exit 0
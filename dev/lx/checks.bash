@@ -0,0 +1,118 @@
+#!/bin/bash
+
+#   ################################################################################################
+#
+#   dev/lx/checks.bash
+#
+#   build the behaviour checks of dev/bench ( *-checks.cpp ) against the patched src/, and run
+#   them ; the C::B sdk is stubbed by dev/bench/stubs, only wxBase is needed. Then expand the
+#   corpus dev/bench/corpus/equiv.txt with src/ and with the svn 11914 src/ref/ ( macros-equiv ),
+#   and compare. Fails when a check fails or when the expansions differ
+#
+#   $1  Ad  C::B project dir
+#
+#   ################################################################################################
+
+#   ------------------------------------------------------------------------------------------------
+#   Vars / options
+#   ------------------------------------------------------------------------------------------------
+AdCbProject="$1"
+#   ------------------------------------------------------------------------------------------------
+if [[ -z "${AdCbProject}" ]] ; then
+    echo "> Parameter #1 'AdCbProject' not defined."
+    exit 1
+fi
+
+AdCbProject="${AdCbProject%/}"                                                                      # C::B $(PROJECT_DIR) comes with a trailing '/'
+
+AdOut="${AdCbProject}/out/bench"
+AdBench="${AdCbProject}/dev/bench"
+
+NuFailed=0
+
+echo "Summary:"                                                                                     # message
+echo "-------"
+echo "AdCbProject :${AdCbProject}"
+echo " "
+#   ------------------------------------------------------------------------------------------------
+#   Functions
+#   ------------------------------------------------------------------------------------------------
+#   $1  Ad  sources dir : src or src/ref
+#   $2  Fn  checks program : dev/bench/$2.cpp, and the executable
+#   $3  Fn  executable, $2 if empty
+Build()
+{
+    local FnExe="${3:-$2}"
+
+    g++ -O1 -std=c++11                                                                              \
+        -I "${AdBench}/stubs"                                                                       \
+        $( wx-config --cxxflags base )                                                              \
+        -I "$1"                                                                                     \
+        "${AdBench}/$2.cpp"                                                                         \
+        "${AdBench}/checks.cpp"                                                                     \
+        "${AdBench}/stubs/stubs.cpp"                                                                \
+        "$1/macrosmanager.cpp"                                                                      \
+        "$1/compileoptionsbase.cpp"                                                                 \
+        $( wx-config --libs base )                                                                  \
+        -o "${AdOut}/${FnExe}"
+}
+
+#   $1  Fn  executable ; its exit code is its number of failed checks
+Run()
+{
+    echo "$1 :"
+    "${AdOut}/$1"
+    NuFailed=$(( NuFailed + $? ))
+    echo " "
+}
+#   ------------------------------------------------------------------------------------------------
+#   Go
+#   ------------------------------------------------------------------------------------------------
+mkdir -p "${AdOut}"
+
+Build "${AdCbProject}/src"      "vars-checks"
+if [[ $(($?)) -ne 0 ]] ; then
+    echo "> build failed ( vars-checks )"
+    exit 1
+fi
+
+Build "${AdCbProject}/src"      "macros-checks"
+if [[ $(($?)) -ne 0 ]] ; then
+    echo "> build failed ( macros-checks )"
+    exit 1
+fi
+
+Build "${AdCbProject}/src"      "macros-equiv"
+if [[ $(($?)) -ne 0 ]] ; then
+    echo "> build failed ( macros-equiv )"
+    exit 1
+fi
+
+Build "${AdCbProject}/src/ref"  "macros-equiv"  "macros-equiv-ref"
+if [[ $(($?)) -ne 0 ]] ; then
+    echo "> build failed ( macros-equiv-ref )"
+    exit 1
+fi
+
+Run "vars-checks"
+Run "macros-checks"
+
+echo "macros-equiv :"
+"${AdOut}/macros-equiv-ref" "${AdBench}/corpus/equiv.txt" > "${AdOut}/equiv-ref.txt"
+"${AdOut}/macros-equiv"     "${AdBench}/corpus/equiv.txt" > "${AdOut}/equiv.txt"
+NuDiffs=$( diff "${AdOut}/equiv-ref.txt" "${AdOut}/equiv.txt" | grep -c "^>" )
+if [[ ${NuDiffs} -ne 0 ]] ; then
+    diff "${AdOut}/equiv-ref.txt" "${AdOut}/equiv.txt"
+    echo "  ${NuDiffs} expansion(s) differ from src/ref"
+    NuFailed=$(( NuFailed + NuDiffs ))
+else
+    echo "  $( wc -l < "${AdOut}/equiv.txt" ) expansion(s), as src/ref"
+fi
+echo " "
+
+if [[ ${NuFailed} -ne 0 ]] ; then
+    echo "> ${NuFailed} check(s) failed"
+    exit 1
+fi
+
+exit 0
@@ -70,3 +70,107 @@ commit efc0b1dabd0e30e6a5e51782a35f9b66622a5a43 ( master <- typedef-CustomVar )
 commit
 ----------------------------------------------------------------------------------------------------    - [master] <- [custom-GetAllVars-one-map]
 
+2026.10.16
+    - CompileOptionsBase::VarEnum() / VarRange replace VarEnumGetFirst() / VarEnumGetNext() : the
+      enumeration cursor is no more a file-static, enumerations are reentrant and thread-safe
+    - CompileOptionsBase : m_Vars split in two flat CustomVarStore, m_ActiveVars and m_InactiveVars
+    - corrected VarGet() which always returned true, and VarUnsetAll() default flags which were 0
+    - vars with flags 0 are now kept with the inactive vars, and enumerated by VarEnum(eVarInactive)
+    - added dev/bench/varstore-bench.cpp, and target lx-bench-vars to run it
+    - CustomVarEntry::keyUpper : upper-cased key built once, used by MacrosManager instead of Upper()
+    - CompileOptionsBase::VarBatch : var mutations applied in one pass, used by DoSaveVars() and
+      ProjectLoader::DoEnvironment()
+    - CompilerOptionsDlg::DoSaveVars() only applies the deleted, renamed and edited vars
+    - CompilerOptionsDlg : the vars page uses CustomVarsDataModel, a virtual model reading the
+      owner's stores, with edits in an overlay
+    - MacrosManager : the macros map is split in versioned layers, RecalcVars() only rebuilds the
+      changed ones ; CompileOptionsBase::GetGeneration(). Added src/macrosmanager.h ( + src/ref copy )
+    - MacrosManager : the compiler / project / target vars layers are views on their owner
+    - MacrosManager::ReplaceMacros() : the regex loops are replaced by CompileMacros(), one linear
+      scan building a MacroTemplate, and EvalNodes() ; a recursion bound ends the loop on A=$(A)
+    - MacrosManager::MacroTemplateCache : compiled templates kept in a LRU of 1024 entries ;
+      MacrosManager::GetCounters() / ResetCounters()
+    - MacrosManager : ReplaceMacros() results cached, keyed by ( input, project, target, compiler,
+      subrequest ) ; counters resultHits, resultMisses, resultVolatile
+    - MacrosManager::ExpandWithDeps(), GetDependents(), VarsChanged() : the results are indexed by
+      the names they read, a var edit drops only the results reading it
+    - MacrosManager::CompileRange() : the closing ')' / '}' / ']]' searches reuse the span already
+      scanned, expansion is linear ; added dev/bench/macros-bench.cpp ( target lx-bench-macros )
+    - MacrosManager : resolved vars, a $VAR / %VAR% reference is resolved once per ResolvedStamp() ;
+      cycles are logged once with their chain and left unexpanded. dev/bench/stubs : LogManager
+    - MacrosManager : FindDelimiter() scans for '$', '%' and '[' 16 ( SSE2 ) or 32 ( AVX2 ) bytes at
+      a time, MACROS_SCAN_SCALAR forces the scalar loop
+    - MacrosManager::EnvGet() : cache of the environment fallback, EnvChanged() ; counters envHits,
+      envMisses
+    - MacrosManager : the builtin macros are slots of their layer, found by a perfect hash of their
+      names ( BuiltinIndex ) built once at first use, not at compile time : C++11 constexpr cannot
+      fill its table
+    - MacrosManager : lazy builtins, the editor position and selection, the std paths and the date
+      are computed by their first reference ( SlotLazy(), SlotFetch() ) ; counter builtinFetches
+    - MacrosManager : $if( ) conditions are parsed once with their template ( ParseCondition() ),
+      their clauses may hold nested constructs ( BracketMatcher ) ; added $ifnum( )
+    - MacrosManager::RunScript() : [[script]] snippets compiled once into Squirrel closures, their
+      output captured ; /*pure*/ snippets run once per ResolvedStamp() ; counters scriptCompiles,
+      scriptRuns, scriptPureHits
+    - MacrosManager : the path functions end at the bracket matching theirs ( BracketMatcher ) and
+      convert their result in place ( ConvertSeparators() ) instead of UnixFilename()
+    - MacrosManager::PathGet() : $TO_ABSOLUTE_PATH{ } / $TO_83_PATH{ } results kept for the
+      working directory they were made in ; counters pathHits, pathMisses
+    - MacrosManager : profile of the expansions per macro and per construct, off by default
+      ( ProfileEnable(), Tools menu ) ; ProfileDump() writes it as JSON
+    - dev/bench/expand-bench.cpp, target lx-bench-expand : replays dev/bench/corpus/commands.txt
+      on projects of 1 to 200 targets of 1 to 10000 vars ; expansions / s, allocations, latency
+    - dev/bench/stubs : sqplus.h, sdk_events.h, wx/menu.h, wx/frame.h and the Manager stand-ins
+      that the [[script]] closures and the expansion profile need
+    - dev/bench/allocs.cpp : the counting operator new / delete are built with BENCH_COUNT_ALLOCS
+    - dev/bench/allocs-bounds.cpp, target lx-bench-allocs : heap allocations per call of the vars
+      and macros hot paths, against an upper bound each
+    - MacrosManager : whether the project moved is known from its filename ( m_ProjectPath ), a
+      cached expansion allocates nothing
+
+2026.10.17
+    - UnsetAllVars() : removed the second SetModified(true), VarUnsetAll() already calls it
+    - added dev/bench/vars-checks.cpp, dev/lx/checks.bash and target lx-checks to run the checks
+    - CustomVarsDataModel : the sort is done on the first row access, not by Attach()
+    - CustomVarsDataModel : rows read empty once the owner's vars changed, renames onto another var
+      are rejected ( by the model and by DoSaveVars() )
+    - VarUnsetAll() / VarBatch::UnsetAll() report the unset keys through VarsModified()
+    - MacrosManager::GetMacros() : compares the owners generations to the ones of its last merge,
+      no more to the ones of RecalcVars() ; counter macrosMerges
+    - added dev/bench/macros-checks.cpp, run by dev/lx/checks.bash
+    - CustomVarStore : the keyUpper index is kept up to date by Insert() / Erase() / Clear(), no more
+      built by FindUpper() in a mutable member
+    - added dev/bench/macros-equiv.cpp and its corpus dev/bench/corpus/equiv.txt, expanded with
+      src/ and with src/ref/ by dev/lx/checks.bash, which compares both
+    - macros-checks : eviction order of the templates LRU
+    - MacrosManager : results and resolved vars reading a global user var or the environment are
+      not cached
+    - macros-checks : results cache, VarsChanged(), global user var and environment changes
+    - CompileOptionsBase::SetVarsListener() : VarsModified() tells the keys to a listener instead of
+      calling MacrosManager, which registers OnVarsModified() for its lifetime
+    - macros-checks : var edits of the project ( VarBatch ) and of the compiler reach VarsChanged()
+    - macros-checks : resolved vars and cycles ; the LogManager stub counts the warnings
+    - macros-checks : environment fallback, EnvChanged()
+    - macros-checks : each builtin name of GetMacros() expands to its value
+    - macros-checks : lazy builtins, computed once by their first reference
+    - MacrosManager : a $if( ) comparison compares its operands as written, as svn 11914 did ;
+      macros-checks : $if( ) and $ifnum( )
+    - MacrosManager::RunScript() : a failing snippet has its errors displayed, it is no more run
+      again by LoadBufferRedirectOutput() ; macros-checks : [[script]], /*pure*/ snippets
+    - dev/bench/stubs : UnixFilename() keeps UNC names in the Windows format, as globals.cpp ;
+      macros-checks : ConvertSeparators() on UNC names and runs of separators
+    - macros-checks : the path functions cache is dropped when the working directory moves
+    - macros-checks : the JSON of ProfileDump(), its syntax, members and types
+    - CB_CVARS__CB_BENCH_TRUNK_DIR is empty by default, bench-vars.bash tells to set it
+    - MacrosManager : the results cache drops its least recently used result when full, instead of
+      all of them ; its capacity follows the project's targets and files ; counter resultEvictions
+    - CompileOptionsBase::VarsModified() : marks the object modified without the virtual SetModified(),
+      which cbProject passes down to its targets ; dev/bench/stubs : cbProject::SetModified() does too ;
+      macros-checks : a project var edit keeps the results of an unrelated input
+    - MacrosManager : a $if( ) comparison holding a ')' ( $(VAR) ) is no $if, its vars are expanded,
+      as svn 11914 whose regex did not match it ; equiv.txt and macros-checks : $if($(FOO)==foo)
+    - MacrosManager : the environment snapshot lives until EnvChanged(), InvalidateResults() or
+      cbEVT_COMPILER_STARTED, no more for one top level ReplaceMacros() ; dev/bench/stubs :
+      cbEVT_COMPILER_STARTED ; macros-checks : the snapshot, absent names included
+    - MacrosManager::RunScript() : a failing snippet is not run nor reported again for the same
+      ResolvedStamp() ; macros-checks : a failed snippet, then a var edit
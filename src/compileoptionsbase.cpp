@@ -16,15 +16,22 @@
     #include "macrosmanager.h"
 #endif
 
-#include <list>
-
 namespace { static const bool s_case_sensitive = platform::windows ? false : true; }
+//  ................................................................................................    ERG+
+unsigned long CompileOptionsBase::s_GlobalGeneration     = 0;
+unsigned long CompileOptionsBase::s_GlobalVarsGeneration = 0;
+CompileOptionsBase::VarsListener CompileOptionsBase::s_VarsListener = nullptr;
+//  ................................................................................................    ERG-
 
 CompileOptionsBase::CompileOptionsBase()
     : m_Platform(spAll),
     m_LinkerExecutable(LinkerExecutableOption::AutoDetect),
     m_Modified(false),
-    m_AlwaysRunPostCmds(false)
+    m_AlwaysRunPostCmds(false),
+    //  ............................................................................................    ERG+
+    m_Generation(0),
+    m_VarsGeneration(0)
+    //  ............................................................................................    ERG-
 {
     //ctor
 }
@@ -266,6 +273,13 @@ bool CompileOptionsBase::GetModified() const
 void CompileOptionsBase::SetModified(bool modified)
 {
     m_Modified = modified;
+    //  ............................................................................................    ERG+
+    if ( modified )
+    {
+        ++m_Generation;
+        ++s_GlobalGeneration;
+    }
+    //  ............................................................................................    ERG-
 }
 
 void CompileOptionsBase::AddLinkerOption(const wxString& option)
@@ -522,48 +536,295 @@ void CompileOptionsBase::RemoveBuildScript(const wxString& script)
     }
 }
 //  ................................................................................................    ERG+
-bool CompileOptionsBase::SetVar(const wxString& key, const wxString& value, bool onlyIfExists)
+//  ................................................................................................
+//  CustomVarStore
+//  ................................................................................................
+CustomVarStore::CustomVarStore()
+    : m_UpperDups(0)
 {
-    return VarSet(key, value, wxString(""), CompileOptionsBase::eVarActive, onlyIfExists);
 }
 
-bool CompileOptionsBase::UnsetVar(const wxString& key)
+size_t CustomVarStore::Hash(wxString const & _i_key)
 {
-    CustomVar cv;
+    size_t h = 2166136261u;                                                                         // FNV-1a
     //  ............................................................................................
-    if ( ! VarGet(key, cv) )
-        return false;
+    for ( wxString::const_iterator it = _i_key.begin() ; it != _i_key.end() ; ++it )
+        h = ( h ^ static_cast< size_t >( wxUniChar(*it).GetValue() ) ) * 16777619u;
 
-    if ( ! ( cv.flags & CompileOptionsBase::eVarActive ) )
-        return false;
+    return h;
+}
 
-    return VarUnset(key);
+size_t CustomVarStore::Slot(wxString const & _i_key, size_t _i_hash) const
+{
+    size_t  mask    =   m_Slots.size() - 1;
+    size_t  s       =   _i_hash & mask;
+    //  ............................................................................................
+    while ( m_Slots[s] >= 0 )
+    {
+        int idx = m_Slots[s];
+
+        if ( ( m_Hashes[idx] == _i_hash ) && ( m_Entries[idx].key == _i_key ) )
+            return s;
+
+        s = ( s + 1 ) & mask;
+    }
+
+    return s;
 }
 
-void CompileOptionsBase::UnsetAllVars()
+void CustomVarStore::Rehash(size_t _i_slots)
 {
-    VarUnsetAll(CompileOptionsBase::eVarActive);
-    SetModified(true);                                                                              // _ERG_CORR_ added, was missing
+    size_t  mask;
+    //  ............................................................................................
+    m_Slots     .assign(_i_slots, -1);
+    m_UpperSlots.assign(_i_slots, -1);
+    m_UpperDups = 0;
+    mask = _i_slots - 1;
+
+    for ( size_t i = 0 ; i != m_Entries.size() ; i++ )
+    {
+        size_t s = m_Hashes[i] & mask;
+
+        while ( m_Slots[s] >= 0 )
+            s = ( s + 1 ) & mask;
+
+        m_Slots[s] = static_cast< int >( i );
+        UpperLink( static_cast< int >( i ) );
+    }
 }
 
-bool CompileOptionsBase::HasVar(const wxString& key) const
+void CustomVarStore::UpperLink(int _i_idx)
+{
+    size_t  mask    =   m_UpperSlots.size() - 1;                                                    // same load factor as m_Slots
+    size_t  h       =   m_UpperHashes[_i_idx];
+    size_t  s       =   h & mask;
+    //  ............................................................................................
+    while ( m_UpperSlots[s] >= 0 )
+    {
+        int idx = m_UpperSlots[s];
+
+        if ( ( m_UpperHashes[idx] == h ) && ( m_Entries[idx].keyUpper == m_Entries[_i_idx].keyUpper ) )
+        {
+            ++m_UpperDups;                                                                          // keys differing only by case : the first one wins
+            return;
+        }
+
+        s = ( s + 1 ) & mask;
+    }
+
+    m_UpperSlots[s] = _i_idx;
+}
+
+void CustomVarStore::Unlink(std::vector< int > & _io_slots, std::vector< size_t > const & _i_hashes, size_t _i_slot)
+{
+    size_t  mask    =   _io_slots.size() - 1;
+    size_t  i       =   _i_slot;
+    size_t  j       =   _i_slot;
+    //  ............................................................................................
+    //  free the slot, and shift back the following slots of the probe sequence that would
+    //  not be reachable anymore
+    _io_slots[i] = -1;
+    for ( ; ; )
+    {
+        j = ( j + 1 ) & mask;
+        if ( _io_slots[j] < 0 )
+            break;
+
+        size_t k = _i_hashes[ _io_slots[j] ] & mask;                                                // home slot of the entry in slot j
+
+        if ( ( i <= j ) ? ( ( i < k ) && ( k <= j ) ) : ( ( i < k ) || ( k <= j ) ) )
+            continue;
+
+        _io_slots[i] = _io_slots[j];
+        _io_slots[j] = -1;
+        i = j;
+    }
+}
+
+size_t CustomVarStore::SlotOf(std::vector< int > const & _i_slots, size_t _i_hash, int _i_idx)
+{
+    size_t  mask    =   _i_slots.size() - 1;
+    size_t  s       =   _i_hash & mask;
+    //  ............................................................................................
+    while ( ( _i_slots[s] >= 0 ) && ( _i_slots[s] != _i_idx ) )
+        s = ( s + 1 ) & mask;
+
+    return s;                                                                                       // holds -1 if _i_idx is not in the table
+}
+
+void CustomVarStore::Reserve(size_t _i_count)
+{
+    size_t  slots   =   16;
+    //  ............................................................................................
+    while ( slots < 2 * _i_count )                                                                  // keep load factor <= 0.5
+        slots *= 2;
+
+    m_Entries    .reserve(_i_count);
+    m_Hashes     .reserve(_i_count);
+    m_UpperHashes.reserve(_i_count);
+
+    if ( slots > m_Slots.size() )
+        Rehash(slots);
+}
+
+int CustomVarStore::Find(wxString const & _i_key) const
+{
+    if ( m_Entries.empty() )
+        return wxNOT_FOUND;
+
+    return m_Slots[ Slot(_i_key, Hash(_i_key)) ];                                                  // -1 == wxNOT_FOUND
+}
+
+int CustomVarStore::FindUpper(wxString const & _i_key_upper) const
+{
+    size_t  h       =   Hash(_i_key_upper);
+    size_t  mask;
+    size_t  s;
+    //  ............................................................................................
+    if ( m_Entries.empty() )
+        return wxNOT_FOUND;
+
+    mask    =   m_UpperSlots.size() - 1;
+    s       =   h & mask;
+    while ( m_UpperSlots[s] >= 0 )
+    {
+        int idx = m_UpperSlots[s];
+
+        if ( ( m_UpperHashes[idx] == h ) && ( m_Entries[idx].keyUpper == _i_key_upper ) )
+            return idx;
+
+        s = ( s + 1 ) & mask;
+    }
+
+    return wxNOT_FOUND;
+}
+
+CustomVarEntry & CustomVarStore::Insert(wxString const & _i_key, CustomVar const & _i_cv)
 {
-    CustomVar cv;
+    size_t  h   =   Hash(_i_key);
+    size_t  s;
     //  ............................................................................................
-    if ( ! VarGet(key, cv) )
+    if ( 2 * ( m_Entries.size() + 1 ) > m_Slots.size() )
+        Rehash( m_Slots.empty() ? 16 : 2 * m_Slots.size() );
+
+    s = Slot(_i_key, h);
+    if ( m_Slots[s] >= 0 )
+    {
+        CustomVarEntry & e = m_Entries[ m_Slots[s] ];
+        e.var = _i_cv;
+        return e;
+    }
+
+    CustomVarEntry e = { _i_key, _i_key.Upper(), _i_cv };
+    m_Slots[s] = static_cast< int >( m_Entries.size() );
+    m_Entries    .push_back(e);
+    m_Hashes     .push_back(h);
+    m_UpperHashes.push_back( Hash(e.keyUpper) );
+    UpperLink( m_Slots[s] );
+
+    return m_Entries.back();
+}
+
+bool CustomVarStore::Erase(wxString const & _i_key)
+{
+    size_t  i, u;
+    int     idx, last;
+    //  ............................................................................................
+    if ( m_Entries.empty() )
         return false;
 
-    if ( ! ( cv.flags & CompileOptionsBase::eVarActive ) )
+    i   = Slot(_i_key, Hash(_i_key));
+    idx = m_Slots[i];
+    if ( idx < 0 )
         return false;
 
+    Unlink(m_Slots, m_Hashes, i);
+    //  ............................................................................................
+    //  by keyUpper : if the entry was the one found for its keyUpper, another entry with the
+    //  same keyUpper ( keys differing only by case ) takes its place
+    u = SlotOf(m_UpperSlots, m_UpperHashes[idx], idx);
+    if ( m_UpperSlots[u] < 0 )
+    {
+        --m_UpperDups;
+    }
+    else
+    {
+        Unlink(m_UpperSlots, m_UpperHashes, u);
+
+        for ( size_t j = 0 ; m_UpperDups && ( j != m_Entries.size() ) ; j++ )
+        {
+            if ( ( static_cast< int >( j ) != idx ) && ( m_UpperHashes[j] == m_UpperHashes[idx] ) && ( m_Entries[j].keyUpper == m_Entries[idx].keyUpper ) )
+            {
+                --m_UpperDups;
+                UpperLink( static_cast< int >( j ) );
+                break;
+            }
+        }
+    }
+    //  ............................................................................................
+    //  move the last entry in the hole
+    last = static_cast< int >( m_Entries.size() ) - 1;
+    if ( idx != last )
+    {
+        m_Slots[ SlotOf(m_Slots, m_Hashes[last], last) ] = idx;
+
+        u = SlotOf(m_UpperSlots, m_UpperHashes[last], last);
+        if ( m_UpperSlots[u] >= 0 )
+            m_UpperSlots[u] = idx;
+
+        m_Entries    [idx]  =   m_Entries    [last];
+        m_Hashes     [idx]  =   m_Hashes     [last];
+        m_UpperHashes[idx]  =   m_UpperHashes[last];
+    }
+
+    m_Entries    .pop_back();
+    m_Hashes     .pop_back();
+    m_UpperHashes.pop_back();
+
+    return true;
+}
+
+void CustomVarStore::Clear()
+{
+    m_Entries    .clear();
+    m_Hashes     .clear();
+    m_UpperHashes.clear();
+    m_Slots     .assign(m_Slots     .size(), -1);                                                   // keep the tables, refilling will not rehash
+    m_UpperSlots.assign(m_UpperSlots.size(), -1);
+    m_UpperDups = 0;
+}
+//  ................................................................................................
+//  CompileOptionsBase
+//  ................................................................................................
+bool CompileOptionsBase::SetVar(const wxString& key, const wxString& value, bool onlyIfExists)
+{
+    return VarSet(key, value, wxString(""), CompileOptionsBase::eVarActive, onlyIfExists);
+}
+
+bool CompileOptionsBase::UnsetVar(const wxString& key)
+{
+    if ( ! m_ActiveVars.Erase(key) )
+        return false;
+
+    VarsModified(wxArrayString(1, &key));
     return true;
 }
 
+void CompileOptionsBase::UnsetAllVars()
+{
+    VarUnsetAll(CompileOptionsBase::eVarActive);                                                    // marked modified if some var was unset
+}
+
+bool CompileOptionsBase::HasVar(const wxString& key) const
+{
+    return ( m_ActiveVars.Find(key) != wxNOT_FOUND );
+}
+
 const wxString& CompileOptionsBase::GetVar(const wxString& key) const
 {
-    CustomVarHash::const_iterator it = m_Vars.find(key);
-    if (it != m_Vars.end())
-        return it->second.value;
+    int idx = m_ActiveVars.Find(key);
+    if ( idx != wxNOT_FOUND )
+        return m_ActiveVars.At(idx).var.value;
 
     static wxString emptystring = wxEmptyString;
     return emptystring;
@@ -571,32 +832,25 @@ const wxString& CompileOptionsBase::GetVar(const wxString& key) const
 //  ................................................................................................
 bool CompileOptionsBase::VarSet(wxString const & _i_key, wxString const & _i_val, wxString const & _i_comment, int _i_flags, bool _i_only_if_exists)
 {
-    CustomVarHash::iterator         it;
-    CustomVar                       cv  = { _i_val, _i_comment, _i_flags };
+    CustomVar                       cv      = { _i_val, _i_comment, _i_flags };
     //  ............................................................................................
-    if ( ! VarGetIterator(_i_key, it) )
-    {
-        if ( _i_only_if_exists )
-            return false;
+    if ( _i_only_if_exists && ! VarFind(_i_key) )
+        return false;
 
-        m_Vars[_i_key] = cv;
-        SetModified(true);
-        return true;
-    }
+    VarApplySet(_i_key, cv);
 
-    it->second = cv;
-    SetModified(true);
+    VarsModified(wxArrayString(1, &_i_key));
     return true;
 }
 
 bool CompileOptionsBase::VarSetValue(wxString const & _i_key, wxString const & _i_val)
 {
-    CustomVarHash::iterator it;
+    CustomVarEntry * e = VarFind(_i_key);
     //  ............................................................................................
-    if ( VarGetIterator(_i_key, it) )
+    if ( e )
     {
-        it->second.value = _i_val;
-        SetModified(true);
+        e->var.value = _i_val;
+        VarsModified(wxArrayString(1, &_i_key));
         return true;
     }
 
@@ -605,12 +859,12 @@ bool CompileOptionsBase::VarSetValue(wxString const & _i_key, wxString const & _
 
 bool CompileOptionsBase::VarSetComment(wxString const & _i_key, wxString const & _i_com)
 {
-    CustomVarHash::iterator it;
+    CustomVarEntry * e = VarFind(_i_key);
     //  ............................................................................................
-    if ( VarGetIterator(_i_key, it) )
+    if ( e )
     {
-        it->second.comment = _i_com;
-        SetModified(true);
+        e->var.comment = _i_com;
+        VarsModified(wxArrayString(1, &_i_key));
         return true;
     }
 
@@ -619,161 +873,311 @@ bool CompileOptionsBase::VarSetComment(wxString const & _i_key, wxString const &
 
 bool CompileOptionsBase::VarSetFlags(wxString const & _i_key, int _i_flags)
 {
-    CustomVarHash::iterator it;
+    CustomVarEntry * e = VarFind(_i_key);
     //  ............................................................................................
-    if ( VarGetIterator(_i_key, it) )
+    if ( ! e )
+        return false;
+
+    if ( ( e->var.flags ^ _i_flags ) & CompileOptionsBase::eVarActive )                            // activity changes : move to the other store
     {
-        it->second.flags = _i_flags;
-        SetModified(true);
+        CustomVar cv = e->var;
+        cv.flags = _i_flags;
+        VarApplySet(_i_key, cv);
+        VarsModified(wxArrayString(1, &_i_key));
         return true;
     }
 
-    return false;
+    e->var.flags = _i_flags;
+    VarsModified(wxArrayString(1, &_i_key));
+    return true;
 }
 
-bool CompileOptionsBase::VarGetIterator(wxString const & _i_key, CustomVarHash::iterator & _o_it)
+CustomVarEntry * CompileOptionsBase::VarFind(wxString const & _i_key)
 {
-    CustomVarHash::iterator     it;
+    int idx;
     //  ............................................................................................
-    it = m_Vars.find(_i_key);
-    if ( it != m_Vars.end() )
-    {
-        _o_it = it;
-        return true;
-    }
+    if ( ( idx = m_ActiveVars.Find(_i_key) ) != wxNOT_FOUND )
+        return &m_ActiveVars.At(idx);
 
-    return false;
+    if ( ( idx = m_InactiveVars.Find(_i_key) ) != wxNOT_FOUND )
+        return &m_InactiveVars.At(idx);
+
+    return nullptr;
 }
 
-bool CompileOptionsBase::VarHas(wxString const & _i_key) const
+CustomVarEntry const * CompileOptionsBase::VarFind(wxString const & _i_key) const
 {
-    CustomVarHash::const_iterator it = m_Vars.find(_i_key);
-    if (it != m_Vars.end())
-        return true;
+    int idx;
+    //  ............................................................................................
+    if ( ( idx = m_ActiveVars.Find(_i_key) ) != wxNOT_FOUND )
+        return &m_ActiveVars.At(idx);
 
-    return false;
+    if ( ( idx = m_InactiveVars.Find(_i_key) ) != wxNOT_FOUND )
+        return &m_InactiveVars.At(idx);
+
+    return nullptr;
+}
+
+bool CompileOptionsBase::VarHas(wxString const & _i_key) const
+{
+    return ( VarFind(_i_key) != nullptr );
 }
 
 bool CompileOptionsBase::VarGet(wxString const & _i_key, CustomVar & _o_cv) const
 {
-    //  Cant use VarGetIterator due to const
-    //  ............................................................................................
-    CustomVarHash::const_iterator   it;
+    CustomVarEntry const * e = VarFind(_i_key);
     //  ............................................................................................
-    it = m_Vars.find(_i_key);
-    if ( it != m_Vars.end() )
-        _o_cv = it->second;
-        return true;
+    if ( ! e )
+        return false;
 
-    return false;
+    _o_cv = e->var;
+    return true;
 }
 
 bool CompileOptionsBase::VarGetValue(wxString const & _i_key, wxString & _o_val) const
 {
-    CustomVar cv;
+    CustomVarEntry const * e = VarFind(_i_key);
     //  ............................................................................................
-    if ( VarGet(_i_key, cv) )
-    {
-        _o_val = cv.value;
-        return true;
-    }
+    if ( ! e )
+        return false;
 
-    return false;
+    _o_val = e->var.value;
+    return true;
 }
 
 bool CompileOptionsBase::VarGetComment(wxString const & _i_key, wxString & _o_com) const
 {
-    CustomVar cv;
+    CustomVarEntry const * e = VarFind(_i_key);
     //  ............................................................................................
-    if ( VarGet(_i_key, cv) )
-    {
-        _o_com = cv.comment;
-        return true;
-    }
+    if ( ! e )
+        return false;
 
-    return false;
+    _o_com = e->var.comment;
+    return true;
 }
 
 bool CompileOptionsBase::VarGetFlags(wxString const & _i_key, int & _o_flags) const
 {
-    CustomVar cv;
+    CustomVarEntry const * e = VarFind(_i_key);
     //  ............................................................................................
-    if ( VarGet(_i_key, cv) )
+    if ( ! e )
+        return false;
+
+    _o_flags = e->var.flags;
+    return true;
+}
+
+bool CompileOptionsBase::VarUnset(wxString const & _i_key)
+{
+    if ( VarApplyUnset(_i_key) )
     {
-        _o_flags = cv.flags;
+        VarsModified(wxArrayString(1, &_i_key));
         return true;
     }
 
     return false;
 }
 
-bool CompileOptionsBase::VarUnset(wxString const & _i_key)
+void CompileOptionsBase::VarUnsetAll(int _i_activity_flags)
+{
+    wxArrayString keys;
+    //  ............................................................................................
+    if ( VarApplyUnsetAll(_i_activity_flags, keys) )
+        VarsModified(keys);
+}
+
+CustomVarEntry const * CompileOptionsBase::VarFindActiveUpper(wxString const & _i_key_upper) const
+{
+    int idx = m_ActiveVars.FindUpper(_i_key_upper);
+    //  ............................................................................................
+    return ( idx != wxNOT_FOUND ) ? &m_ActiveVars.At(idx) : nullptr;
+}
+
+bool CompileOptionsBase::VarApplySet(wxString const & _i_key, CustomVar const & _i_cv)
 {
-    CustomVarHash::iterator     it;
+    bool                active  =   ( _i_cv.flags & CompileOptionsBase::eVarActive ) ? true : false;
+    CustomVarStore  &   dst     =   active ? m_ActiveVars   : m_InactiveVars;
+    CustomVarStore  &   oth     =   active ? m_InactiveVars : m_ActiveVars;
+    int                 idx;
     //  ............................................................................................
-    if ( VarGetIterator(_i_key, it) )
+    if ( ( idx = dst.Find(_i_key) ) != wxNOT_FOUND )
     {
-        m_Vars.erase(it);
-        SetModified(true);
+        CustomVar & cv = dst.At(idx).var;
+
+        if ( ( cv.flags == _i_cv.flags ) && ( cv.value == _i_cv.value ) && ( cv.comment == _i_cv.comment ) )
+            return false;
+
+        cv = _i_cv;
         return true;
     }
 
-    return false;
+    oth.Erase(_i_key);
+    dst.Insert(_i_key, _i_cv);
+    return true;
 }
 
-void CompileOptionsBase::VarUnsetAll(int _i_activity_flags)
+bool CompileOptionsBase::VarApplyUnset(wxString const & _i_key)
+{
+    return ( m_ActiveVars.Erase(_i_key) || m_InactiveVars.Erase(_i_key) );
+}
+
+void CompileOptionsBase::VarsModified(wxArrayString const & _i_keys)
+{
+    //  Not the virtual SetModified() : cbProject's passes it down to its targets, whose options
+    //  generations would then move for a var edit of the project.
+    m_Modified = true;
+    ++m_Generation;
+    ++m_VarsGeneration;
+    ++s_GlobalGeneration;
+    ++s_GlobalVarsGeneration;
+
+    if ( s_VarsListener )
+        s_VarsListener(_i_keys);
+}
+
+bool CompileOptionsBase::VarApplyUnsetAll(int _i_activity_flags, wxArrayString & _io_keys)
 {
-    std::list< wxString >       lst;
-    CustomVarHash::iterator     it;
+    bool    changed     =   false;
     //  ............................................................................................
-    for ( it = m_Vars.begin() ; it != m_Vars.end() ; it++ )
+    if ( ( _i_activity_flags & CompileOptionsBase::eVarActive ) && ! m_ActiveVars.Empty() )
     {
-        if ( it->second.flags & _i_activity_flags )
-        {
-            lst.push_front( it->first );
-        }
+        for ( size_t i = 0 ; i != m_ActiveVars.Size() ; i++ )
+            _io_keys.Add( m_ActiveVars.At(i).key );
+        m_ActiveVars.Clear();
+        changed = true;
     }
 
-    for ( std::list< wxString >::iterator jt = lst.begin() ; jt != lst.end() ; jt++ )
+    if ( ( _i_activity_flags & CompileOptionsBase::eVarInactive ) && ! m_InactiveVars.Empty() )
     {
-        m_Vars.erase( *jt );
+        for ( size_t i = 0 ; i != m_InactiveVars.Size() ; i++ )
+            _io_keys.Add( m_InactiveVars.At(i).key );
+        m_InactiveVars.Clear();
+        changed = true;
     }
 
-    if ( ! lst.empty() )
-        SetModified(true);
+    return changed;
 }
 
-//  this variables because in CB code, "gettin all vars()" assumes const objects ( typically
-//  a const CompileOptionsBase object ). So we cant define the these two vars as class members.
-static  int                                 m_VarEnumFlags;
-static  CustomVarHash::const_iterator       m_VarEnumIterator;
+CompileOptionsBase::VarRange CompileOptionsBase::VarEnum(int _i_flags) const
+{
+    return VarRange( ( _i_flags & CompileOptionsBase::eVarActive   ) ? &m_ActiveVars   : nullptr,
+                     ( _i_flags & CompileOptionsBase::eVarInactive ) ? &m_InactiveVars : nullptr );
+}
+//  ................................................................................................
+//  CompileOptionsBase::VarBatch
+//  ................................................................................................
+CompileOptionsBase::VarBatch::VarBatch(CompileOptionsBase & _i_owner)
+    : m_Owner(_i_owner)
+{
+}
 
-CustomVarHash::const_iterator* CompileOptionsBase::VarEnumFind() const
+void CompileOptionsBase::VarBatch::Set(wxString const & _i_key, wxString const & _i_val, wxString const & _i_comment, int _i_flags)
 {
-    while ( m_VarEnumIterator != m_Vars.end() )
-    {
-        if ( m_VarEnumIterator->second.flags & m_VarEnumFlags )
-            return &m_VarEnumIterator;
+    Op o = { eOpSet, _i_key, { _i_val, _i_comment, _i_flags } };
+    m_Ops.push_back(o);
+}
 
-        m_VarEnumIterator++;
-    }
+void CompileOptionsBase::VarBatch::SetValue(wxString const & _i_key, wxString const & _i_val)
+{
+    Op o = { eOpSetValue, _i_key, { _i_val, wxEmptyString, 0 } };
+    m_Ops.push_back(o);
+}
 
-    return nullptr;
+void CompileOptionsBase::VarBatch::SetComment(wxString const & _i_key, wxString const & _i_com)
+{
+    Op o = { eOpSetComment, _i_key, { wxEmptyString, _i_com, 0 } };
+    m_Ops.push_back(o);
+}
+
+void CompileOptionsBase::VarBatch::SetFlags(wxString const & _i_key, int _i_flags)
+{
+    Op o = { eOpSetFlags, _i_key, { wxEmptyString, wxEmptyString, _i_flags } };
+    m_Ops.push_back(o);
 }
 
-CustomVarHash::const_iterator* CompileOptionsBase::VarEnumGetFirst(int _i_flags) const
+void CompileOptionsBase::VarBatch::Unset(wxString const & _i_key)
 {
-    m_VarEnumFlags      =   _i_flags;
-    m_VarEnumIterator   =   m_Vars.begin();
+    Op o = { eOpUnset, _i_key, { wxEmptyString, wxEmptyString, 0 } };
+    m_Ops.push_back(o);
+}
 
-    return VarEnumFind();
- }
+void CompileOptionsBase::VarBatch::UnsetAll(int _i_activity_flags)
+{
+    Op o = { eOpUnsetAll, wxEmptyString, { wxEmptyString, wxEmptyString, _i_activity_flags } };
+    m_Ops.push_back(o);
+}
 
-CustomVarHash::const_iterator* CompileOptionsBase::VarEnumGetNext() const
+bool CompileOptionsBase::VarBatch::Commit()
 {
-    m_VarEnumIterator++;
+    size_t          na          =   0;
+    size_t          ni          =   0;
+    bool            changed     =   false;
+    wxArrayString   keys;
+    //  ............................................................................................
+    //  size the stores once for the worst case : every set / flag flip adds a var
+    for ( std::vector< Op >::const_iterator it = m_Ops.begin() ; it != m_Ops.end() ; ++it )
+    {
+        if ( ( it->op == eOpSet ) || ( it->op == eOpSetFlags ) )
+        {
+            if ( it->cv.flags & CompileOptionsBase::eVarActive )
+                na++;
+            else
+                ni++;
+        }
+    }
+
+    if ( na )
+        m_Owner.m_ActiveVars  .Reserve( m_Owner.m_ActiveVars  .Size() + na );
+    if ( ni )
+        m_Owner.m_InactiveVars.Reserve( m_Owner.m_InactiveVars.Size() + ni );
+    //  ............................................................................................
+    for ( std::vector< Op >::const_iterator it = m_Ops.begin() ; it != m_Ops.end() ; ++it )
+    {
+        bool done = false;
+
+        if ( it->op == eOpSet )
+        {
+            done = m_Owner.VarApplySet(it->key, it->cv);
+        }
+        else if ( it->op == eOpUnset )
+        {
+            done = m_Owner.VarApplyUnset(it->key);
+        }
+        else if ( it->op == eOpUnsetAll )
+        {
+            changed |= m_Owner.VarApplyUnsetAll(it->cv.flags, keys);
+            continue;
+        }
+        else
+        {
+            CustomVarEntry * e = m_Owner.VarFind(it->key);
+            if ( ! e )
+                continue;
+
+            CustomVar cv = e->var;
+            if ( it->op == eOpSetValue )
+                cv.value    = it->cv.value;
+            else if ( it->op == eOpSetComment )
+                cv.comment  = it->cv.comment;
+            else
+                cv.flags    = it->cv.flags;
+
+            done = m_Owner.VarApplySet(it->key, cv);
+        }
+
+        if ( done )
+        {
+            keys.Add(it->key);
+            changed = true;
+        }
+    }
+
+    m_Ops.clear();
+
+    if ( changed )
+        m_Owner.VarsModified(keys);
 
-    return VarEnumFind();
+    return changed;
 }
 //  ................................................................................................    ERG-
 void CompileOptionsBase::SetLinkerExecutable(LinkerExecutableOption option)
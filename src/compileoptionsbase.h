@@ -8,6 +8,7 @@
 
 #include "globals.h"
 #include <wx/hashmap.h>
+#include <vector>
 
 WX_DECLARE_STRING_HASH_MAP(wxString, StringHash);
 
@@ -18,7 +19,57 @@ typedef struct
     int         flags;
 } CustomVar;
 
-WX_DECLARE_STRING_HASH_MAP(CustomVar, CustomVarHash);
+/// A CustomVar and its key, as stored in a CustomVarStore.
+struct CustomVarEntry
+{
+    wxString    key;
+    wxString    keyUpper;                                                                           //!< key.Upper(), built once when the entry is created ( macros keys )
+    CustomVar   var;
+};
+
+/** Flat store of CustomVars. The entries are kept in a contiguous vector, so that enumerating
+  * is a linear walk over memory. Keys are found through an open-addressing table ( linear
+  * probing ) of entry indexes ; the hash of each key is computed once, when it is inserted.
+  * Erasing an entry moves the last entry in its place, so entries have no stable order.
+  * A second table indexes the entries by keyUpper, for the case-insensitive lookups of the
+  * MacrosManager ; Insert(), Erase() and Clear() keep it up to date, so that the const
+  * lookups never write and may run from several threads.
+  */
+class DLLIMPORT CustomVarStore
+{
+    public:
+        CustomVarStore();
+
+        int                         Find    (wxString const & _i_key) const;                        //!< index of the entry, or wxNOT_FOUND
+        int                         FindUpper(wxString const & _i_key_upper) const;                 //!< index of an entry whose keyUpper is _i_key_upper, or wxNOT_FOUND
+        CustomVarEntry          &   Insert  (wxString const & _i_key, CustomVar const & _i_cv);     //!< insert or overwrite an entry
+        bool                        Erase   (wxString const & _i_key);                              //!< erase an entry ; false if absent
+        void                        Clear   ();
+        void                        Reserve (size_t _i_count);                                      //!< rehash now for _i_count entries
+
+        size_t                      Size    ()                  const   { return m_Entries.size();      }
+        bool                        Empty   ()                  const   { return m_Entries.empty();     }
+        CustomVarEntry  const   *   Data    ()                  const   { return m_Entries.data();      }
+        CustomVarEntry  const   &   At      (size_t _i_idx)     const   { return m_Entries[_i_idx];     }
+        CustomVarEntry          &   At      (size_t _i_idx)             { return m_Entries[_i_idx];     }
+
+        static  size_t              Hash    (wxString const & _i_key);
+
+    private:
+        size_t                      Slot    (wxString const & _i_key, size_t _i_hash) const;        //!< slot of the key, or first free slot
+        void                        Rehash  (size_t _i_slots);                                  //!< rebuild both tables
+        void                        UpperLink(int _i_idx);                                          //!< add an entry to m_UpperSlots, unless its keyUpper is there
+
+        static  void                Unlink  (std::vector< int > & _io_slots, std::vector< size_t > const & _i_hashes, size_t _i_slot);
+        static  size_t              SlotOf  (std::vector< int > const & _i_slots, size_t _i_hash, int _i_idx);
+
+        std::vector< CustomVarEntry >   m_Entries;
+        std::vector< size_t >           m_Hashes;                                                   //!< m_Hashes[i] is the hash of m_Entries[i].key
+        std::vector< size_t >           m_UpperHashes;                                              //!< m_UpperHashes[i] is the hash of m_Entries[i].keyUpper
+        std::vector< int >              m_Slots;                                                    //!< entry index or -1 ; size is 0 or a power of 2
+        std::vector< int >              m_UpperSlots;                                               //!< same, by keyUpper ; same size as m_Slots
+        size_t                          m_UpperDups;                                                //!< entries not in m_UpperSlots, their keyUpper being there
+};
 
 /// Enum which specifies which executable from the toolchain executables would be used for linking
 /// the target.
@@ -127,6 +178,28 @@ class DLLIMPORT CompileOptionsBase
 
         virtual bool GetModified() const;
         virtual void SetModified(bool modified);
+        //  ........................................................................................    ERG+
+        /** Modification generation : incremented by each SetModified(true), never reset. Caches
+          * built from this object ( e.g. the MacrosManager layers ) compare it to the value they
+          * were built with, instead of rereading the object.
+          */
+        unsigned long GetGeneration() const { return m_Generation; }
+
+        /** Part of the generation due to the var edits, UnsetAll included : their keys are also
+          * told to the vars listener ( MacrosManager::VarsChanged() ), which only drops the
+          * results reading these vars. GetOptionsGeneration() moves with everything else.
+          */
+        unsigned long GetVarsGeneration   () const { return m_VarsGeneration;                   }
+        unsigned long GetOptionsGeneration() const { return m_Generation - m_VarsGeneration;    }
+
+        /// Incremented by each SetModified(true) of any object : a change somewhere, never reset.
+        static unsigned long GetGlobalGeneration()          { return s_GlobalGeneration;                            }
+        static unsigned long GetGlobalOptionsGeneration()   { return s_GlobalGeneration - s_GlobalVarsGeneration;   }
+
+        /// Told the keys of each var edit, of any object ; one listener, nullptr for none.
+        typedef void (*VarsListener)(wxArrayString const & _i_keys);
+        static void SetVarsListener(VarsListener _i_listener)   { s_VarsListener = _i_listener; }
+        //  ........................................................................................    ERG-
 
         virtual bool GetAlwaysRunPostBuildSteps() const;
         virtual void SetAlwaysRunPostBuildSteps(bool always);
@@ -155,7 +228,14 @@ class DLLIMPORT CompileOptionsBase
         virtual bool VarSetComment(wxString const & _i_key, wxString const & _i_com);
         virtual bool VarSetFlags  (wxString const & _i_key, int   _i_flags);
     private:
-                bool VarGetIterator(wxString const & _i_key, CustomVarHash::iterator & _o_it);
+                CustomVarEntry          *   VarFind(wxString const & _i_key);
+                CustomVarEntry  const   *   VarFind(wxString const & _i_key) const;
+
+                bool VarApplySet     (wxString const & _i_key, CustomVar const & _i_cv);                //!< set without notification ; true if changed
+                bool VarApplyUnset   (wxString const & _i_key);                                         //!< unset without notification ; true if changed
+                bool VarApplyUnsetAll(int _i_activity_flags, wxArrayString & _io_keys);                 //!< unset without notification, add the keys to _io_keys ; true if changed
+
+                void VarsModified    (wxArrayString const & _i_keys);                                   //!< modified, for edits of these vars only ; not passed down
 
     public:
         virtual bool VarHas       (wxString const & _i_key) const;
@@ -165,13 +245,140 @@ class DLLIMPORT CompileOptionsBase
         virtual bool VarGetFlags  (wxString const & _i_key, int & _o_flags) const;
 
         virtual bool VarUnset(wxString const & _i_key);
-        virtual void VarUnsetAll(int _i_activity_flags = (eVarActive & eVarInactive));
+        virtual void VarUnsetAll(int _i_activity_flags = eVarAll);
 
-    private:
-                CustomVarHash::const_iterator * VarEnumFind() const;
+                CustomVarEntry  const   *   VarFindActiveUpper(wxString const & _i_key_upper) const;    //!< active var whose keyUpper is _i_key_upper ( macros lookups ), or nullptr
+
+        //  var enumeration :
     public:
-                CustomVarHash::const_iterator * VarEnumGetFirst(int _i_flags = eVarActive) const;
-                CustomVarHash::const_iterator * VarEnumGetNext() const;
+        /** Const enumeration of the CustomVars matching an activity filter ( eVarActive, ... ).
+          * The cursor lives in the iterator itself, so several enumerations of the same or of
+          * different CompileOptionsBase objects may run at the same time, from different threads,
+          * without any locking and without any heap allocation. Active vars are enumerated first,
+          * an eVarActive enumeration does not touch inactive vars at all. CustomVarEntry::keyUpper
+          * provides the macro key of each var without any Upper() call.
+          * \code
+          * for ( CustomVarEntry const & e : base->VarEnum(CompileOptionsBase::eVarAll) )
+          *     DoSomething(e.key, e.var);
+          * \endcode
+          * The enumerated object must not be modified while an enumeration is running.
+          */
+        class VarRange
+        {
+            public:
+                class const_iterator
+                {
+                    public:
+                        const_iterator(CustomVarEntry const * _i_cur, CustomVarEntry const * _i_end, CustomVarStore const * _i_next)
+                            : m_Cur(_i_cur), m_End(_i_end), m_Next(_i_next)     { Skip();                           }
+
+                        CustomVarEntry  const   &   operator* () const          { return *m_Cur;                    }
+                        CustomVarEntry  const   *   operator->() const          { return m_Cur;                     }
+                        const_iterator          &   operator++()                { ++m_Cur; Skip(); return *this;    }
+
+                        bool operator==(const_iterator const & _i_other) const  { return m_Cur == _i_other.m_Cur;   }
+                        bool operator!=(const_iterator const & _i_other) const  { return m_Cur != _i_other.m_Cur;   }
+
+                    private:
+                        void Skip()                                                                 // go to the second store when the first one is exhausted
+                        {
+                            if ( ( m_Cur == m_End ) && m_Next )
+                            {
+                                m_Cur   =   m_Next->Data();
+                                m_End   =   m_Cur + m_Next->Size();
+                                m_Next  =   nullptr;
+                            }
+                        }
+
+                        CustomVarEntry  const   *   m_Cur;
+                        CustomVarEntry  const   *   m_End;
+                        CustomVarStore  const   *   m_Next;
+                };
+
+            public:
+                VarRange(CustomVarStore const * _i_first, CustomVarStore const * _i_second)                 // any of them may be null
+                    : m_First(_i_first ? _i_first : _i_second), m_Second(_i_first ? _i_second : nullptr)    {   }
+
+                const_iterator  begin() const
+                {
+                    if ( ! m_First )
+                        return const_iterator(nullptr, nullptr, nullptr);
+                    return const_iterator(m_First->Data(), m_First->Data() + m_First->Size(), m_Second);
+                }
+                const_iterator  end  () const
+                {
+                    CustomVarStore const * last = m_Second ? m_Second : m_First;
+                    if ( ! last )
+                        return const_iterator(nullptr, nullptr, nullptr);
+                    return const_iterator(last->Data() + last->Size(), last->Data() + last->Size(), nullptr);
+                }
+
+                size_t  size() const                                                                //!< number of CustomVars in the range
+                {
+                    return ( m_First ? m_First->Size() : 0 ) + ( m_Second ? m_Second->Size() : 0 );
+                }
+                CustomVarEntry  const   &   operator[](size_t _i_idx) const                         //!< random access, first store then second one
+                {
+                    return ( _i_idx < m_First->Size() ) ? m_First->At(_i_idx) : m_Second->At(_i_idx - m_First->Size());
+                }
+
+            private:
+                CustomVarStore  const   *   m_First;
+                CustomVarStore  const   *   m_Second;
+        };
+
+                VarRange VarEnum(int _i_flags = eVarActive) const;                                  //!< enumerate the CustomVars matching _i_flags
+
+        //  batch mutations :
+    public:
+        /** Records var mutations, and applies them all in one pass on Commit() : the stores are
+          * rehashed at most once, and VarsModified() is called once, only if something really
+          * changed. Mutations are applied in the order they were recorded ; the ones not
+          * committed when the batch is destroyed are discarded.
+          * \code
+          * CompileOptionsBase::VarBatch batch(*base);
+          * batch.UnsetAll();
+          * batch.Set(key, value, comment, CompileOptionsBase::eVarActive);
+          * batch.Commit();
+          * \endcode
+          */
+        class DLLIMPORT VarBatch
+        {
+            public:
+                explicit VarBatch(CompileOptionsBase & _i_owner);
+
+                void Set       (wxString const & _i_key, wxString const & _i_val, wxString const & _i_comment, int _i_flags);
+                void SetValue  (wxString const & _i_key, wxString const & _i_val);                  //!< no effect if the var does not exist
+                void SetComment(wxString const & _i_key, wxString const & _i_com);                  //!< no effect if the var does not exist
+                void SetFlags  (wxString const & _i_key, int _i_flags);                             //!< no effect if the var does not exist
+                void Unset     (wxString const & _i_key);
+                void UnsetAll  (int _i_activity_flags = eVarAll);
+
+                bool Commit();                                                                      //!< apply and clear the batch ; true if the owner changed
+                void Clear()                                { m_Ops.clear();        }               //!< discard the recorded mutations
+                bool IsEmpty() const                        { return m_Ops.empty(); }
+
+            private:
+                enum
+                {
+                    eOpSet          ,
+                    eOpSetValue     ,
+                    eOpSetComment   ,
+                    eOpSetFlags     ,
+                    eOpUnset        ,
+                    eOpUnsetAll
+                };
+
+                struct Op
+                {
+                    int         op;
+                    wxString    key;
+                    CustomVar   cv;
+                };
+
+                CompileOptionsBase      &   m_Owner;
+                std::vector< Op >           m_Ops;
+        };
         //  ........................................................................................    ERG-
     protected:
         int m_Platform;
@@ -189,8 +396,14 @@ class DLLIMPORT CompileOptionsBase
         bool m_Modified;
         bool m_AlwaysRunPostCmds;
         //  ........................................................................................    ERG+
-        CustomVarHash   m_Vars;                                                                     //!< map for CustomVars
-        //  ........................................................................................    ERG+
+        CustomVarStore  m_ActiveVars;                                                               //!< active CustomVars
+        CustomVarStore  m_InactiveVars;                                                             //!< inactive CustomVars ; a key is never in both stores
+        unsigned long   m_Generation;                                                               //!< cf GetGeneration()
+        unsigned long   m_VarsGeneration;                                                           //!< cf GetVarsGeneration()
+        static unsigned long s_GlobalGeneration;                                                    //!< cf GetGlobalGeneration()
+        static unsigned long s_GlobalVarsGeneration;
+        static VarsListener  s_VarsListener;                                                        //!< cf SetVarsListener()
+        //  ........................................................................................    ERG-
     private:
 
 };
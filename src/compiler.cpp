@@ -584,8 +584,8 @@ void Compiler::SaveSettings(const wxString& baseKey)
     //  ERG const CustomVarHash& v = GetAllVars();
     //  ERG for (CustomVarHash::const_iterator it = v.begin(); it != v.end(); ++it)
     //  ERG     cfg->Write(configpath + it->first, it->second.value);
-    for ( CustomVarHash::const_iterator * it = VarEnumGetFirst() ; it != nullptr ; it = VarEnumGetNext() )
-        cfg->Write(configpath + (*it)->first, (*it)->second.value);
+    for ( CustomVarEntry const & e : VarEnum() )
+        cfg->Write(configpath + e.key, e.var.value);
     //  ............................................................................................    ERG-
 }
 
@@ -1233,6 +1233,9 @@ bool Compiler::EvalXMLCondition(const wxXmlNode* node)
                 path.Prepend(masterPath + wxPATH_SEP + masterPath + wxFILE_SEP_PATH + wxT("bin") + wxPATH_SEP);
         }
         wxSetEnv(wxT("PATH"), path);
+        //  ........................................................................................    ERG+
+        Manager::Get()->GetMacrosManager()->EnvChanged(wxT("PATH"));                                // the macros cache the environment
+        //  ........................................................................................    ERG-
         cmd[0] = GetExecName(cmd[0]);
 
         long ret = -1;
@@ -1271,6 +1274,9 @@ bool Compiler::EvalXMLCondition(const wxXmlNode* node)
             val = true;
 
         wxSetEnv(wxT("PATH"), origPath); // restore path
+        //  ........................................................................................    ERG+
+        Manager::Get()->GetMacrosManager()->EnvChanged(wxT("PATH"));
+        //  ........................................................................................    ERG-
     }
     return val;
 }
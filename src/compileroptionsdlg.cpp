@@ -44,6 +44,8 @@
 #include <wx/propgrid/propgrid.h>
 #include <wx/xml/xml.h>
 //  ................................................................................................    ERG+
+#include <map>
+#include <set>
 #include <wx/dataview.h>
 //  ................................................................................................    ERG-
 #include "advancedcompileroptionsdlg.h"
@@ -224,6 +226,314 @@ struct VariableListClientData : wxClientData
     VariableListClientData(const wxString &key, const wxString &value) : key(key), value(value) {}
     wxString key, value;
 };
+//  ................................................................................................    ERG+
+/** Virtual model of the custom vars page : rows are read straight from the owner's var stores,
+  * and edits are kept in an overlay until DoSaveVars() commits them. Attach() is O(1), and the
+  * control only asks for the rows it displays.
+  *
+  * A row id is an index in the owner's VarEnum(eVarAll) range, or a number above the range's size
+  * for appended rows. m_Ids maps the model's rows to ids ; it is only filled once a row is deleted
+  * or the rows are sorted, until then row == id. The user's sort is kept across Attach(), and
+  * done on the first row access after it ( m_SortPending ), not by Attach() itself.
+  *
+  * The owner's vars must not change while attached : after a commit, Attach() again. If they
+  * changed anyway ( IsStale() ), the owner's rows read empty and are not edited.
+  */
+class CustomVarsDataModel : public wxDataViewVirtualListModel
+{
+    public:
+        enum
+        {
+            eColActive  ,
+            eColKey     ,
+            eColValue   ,
+            eColComment ,                                                                           //!< not displayed, edited with txtComment
+            eColCount
+        };
+
+        struct RowEdit
+        {
+            wxString        origKey;                                                                //!< owner's var key ; empty for appended rows
+            bool            removed;
+            bool            active;
+            wxString        key;
+            wxString        value;
+            wxString        comment;
+        };
+        typedef std::map< unsigned int, RowEdit > EditMap;                                          //!< by row id
+
+    public:
+        CustomVarsDataModel()
+            :   wxDataViewVirtualListModel(0),
+                m_Owner(nullptr), m_OwnerVarsGen(0),
+                m_Base(nullptr, nullptr), m_BaseSize(0), m_NextId(0), m_Identity(true), m_Cleared(false),
+                m_SortCol(wxNOT_FOUND), m_SortAscending(true), m_SortPending(false)             {   }
+
+        void            Attach      (CompileOptionsBase const * _i_owner);                          //!< view _i_owner's vars, drop the overlay
+        unsigned int    AppendVar   (bool _i_active, wxString const & _i_key, wxString const & _i_val, wxString const & _i_com);
+        void            DeleteRow   (unsigned int _i_row);
+        void            DeleteAll   ();
+        void            Sort        (int _i_col, bool _i_ascending);
+        int             FindKey     (wxString const & _i_key) const;                                //!< first row with that key, or wxNOT_FOUND
+        bool            KeyTaken    (wxString const & _i_key, unsigned int _i_id) const;            //!< a row other than _i_id has that key
+        bool            IsStale     () const;                                                       //!< the owner's vars changed since Attach()
+
+        bool            IsEdited        ()  const   { return m_Cleared || ! m_Edits.empty();    }
+        bool            IsCleared       ()  const   { return m_Cleared;                         }   //!< DeleteAll() was called since Attach()
+        int             GetSortColumn   ()  const   { return m_SortCol;                         }
+        bool            IsSortAscending ()  const   { return m_SortAscending;                   }
+        EditMap const & GetEdits        ()  const   { return m_Edits;                           }
+
+        virtual unsigned int    GetColumnCount  ()                      const   { return eColCount; }
+        virtual wxString        GetColumnType   (unsigned int _i_col)   const   { return ( _i_col == eColActive ) ? wxString("bool") : wxString("string"); }
+        virtual void            GetValueByRow   (wxVariant & _o_var, unsigned int _i_row, unsigned int _i_col) const;
+        virtual bool            SetValueByRow   (wxVariant const & _i_var, unsigned int _i_row, unsigned int _i_col);
+
+    private:
+        unsigned int            Id          (unsigned int _i_row)   const;
+        CustomVarEntry  const * BaseEntry   (unsigned int _i_id)    const;                          //!< owner's var of a row id, or nullptr ( appended row, stale model )
+        RowEdit         *       EditOf      (unsigned int _i_id);                                   //!< created from the owner's var on first edit ; nullptr if stale
+        void                    Materialize ()                      const;                          //!< fill m_Ids from the identity mapping
+        void                    SortIds     ()                      const;
+        bool                    CellActive  (unsigned int _i_id)                        const;
+        wxString const  &       CellText    (unsigned int _i_id, unsigned int _i_col)   const;
+
+        CompileOptionsBase  const       *   m_Owner;
+        unsigned long                       m_OwnerVarsGen;                                         //!< m_Owner->GetVarsGeneration() at Attach()
+        CompileOptionsBase::VarRange        m_Base;
+        unsigned int                        m_BaseSize;
+        unsigned int                        m_NextId;                                               //!< id of the next appended row
+        mutable std::vector< unsigned int > m_Ids;                                                  //!< mutable : the pending sort is done by the first
+        mutable bool                        m_Identity;                                             //!<   row access, a const one ( GUI thread only )
+        bool                                m_Cleared;
+        EditMap                             m_Edits;
+        int                                 m_SortCol;
+        bool                                m_SortAscending;
+        mutable bool                        m_SortPending;
+};
+
+void CustomVarsDataModel::Attach(CompileOptionsBase const * _i_owner)
+{
+    m_Owner         =   _i_owner;
+    m_OwnerVarsGen  =   _i_owner ? _i_owner->GetVarsGeneration() : 0;
+    m_Base          =   _i_owner ? _i_owner->VarEnum(CompileOptionsBase::eVarAll) : CompileOptionsBase::VarRange(nullptr, nullptr);
+    m_BaseSize      =   m_Base.size();
+    m_NextId        =   m_BaseSize;
+    m_Identity      =   true;
+    m_Cleared       =   false;
+    m_SortPending   =   ( m_SortCol != wxNOT_FOUND );                                               // keep the user's sort across targets, sorted on demand
+    m_Ids.clear();
+    m_Edits.clear();
+
+    Reset(m_BaseSize);
+}
+
+bool CustomVarsDataModel::IsStale() const
+{
+    return m_Owner && ( m_Owner->GetVarsGeneration() != m_OwnerVarsGen );
+}
+
+unsigned int CustomVarsDataModel::Id(unsigned int _i_row) const
+{
+    if ( m_SortPending )
+        SortIds();
+
+    return m_Identity ? _i_row : m_Ids[_i_row];
+}
+
+CustomVarEntry const * CustomVarsDataModel::BaseEntry(unsigned int _i_id) const
+{
+    if ( ( _i_id >= m_BaseSize ) || IsStale() || ( _i_id >= m_Base.size() ) )
+        return nullptr;
+
+    return &m_Base[_i_id];
+}
+
+unsigned int CustomVarsDataModel::AppendVar(bool _i_active, wxString const & _i_key, wxString const & _i_val, wxString const & _i_com)
+{
+    RowEdit         re  =   { wxString(), false, _i_active, _i_key, _i_val, _i_com };
+    unsigned int    id  =   m_NextId++;
+    //  ............................................................................................
+    m_Edits[id] = re;
+
+    if ( m_SortPending )                                                                            // the appended row goes last, after the sorted ones
+        SortIds();
+    if ( ! m_Identity )
+        m_Ids.push_back(id);
+
+    RowAppended();
+    return GetCount() - 1;
+}
+
+void CustomVarsDataModel::DeleteRow(unsigned int _i_row)
+{
+    RowEdit * re = EditOf( Id(_i_row) );
+    //  ............................................................................................
+    if ( ! re )
+        return;
+
+    Materialize();
+
+    re->removed = true;
+    m_Ids.erase(m_Ids.begin() + _i_row);
+
+    RowDeleted(_i_row);
+}
+
+void CustomVarsDataModel::DeleteAll()
+{
+    m_Identity      =   false;
+    m_Cleared       =   true;                                                                       // DoSaveVars() will unset all the owner's vars
+    m_SortPending   =   false;
+    m_Ids.clear();
+    m_Edits.clear();
+
+    Reset(0);
+}
+
+void CustomVarsDataModel::Sort(int _i_col, bool _i_ascending)
+{
+    m_SortCol       =   _i_col;
+    m_SortAscending =   _i_ascending;
+    m_SortPending   =   true;
+
+    Reset(GetCount());
+}
+
+int CustomVarsDataModel::FindKey(wxString const & _i_key) const
+{
+    for ( unsigned int row = 0 ; row != GetCount() ; row++ )
+    {
+        if ( CellText(Id(row), eColKey) == _i_key )
+            return row;
+    }
+
+    return wxNOT_FOUND;
+}
+
+bool CustomVarsDataModel::KeyTaken(wxString const & _i_key, unsigned int _i_id) const
+{
+    for ( unsigned int row = 0 ; row != GetCount() ; row++ )
+    {
+        unsigned int id = Id(row);
+
+        if ( ( id != _i_id ) && ( wxString( CellText(id, eColKey) ).Trim(true).Trim(false) == _i_key ) )
+            return true;
+    }
+
+    return false;
+}
+
+void CustomVarsDataModel::GetValueByRow(wxVariant & _o_var, unsigned int _i_row, unsigned int _i_col) const
+{
+    if ( _i_col == eColActive )
+        _o_var = CellActive(Id(_i_row));
+    else
+        _o_var = CellText(Id(_i_row), _i_col);
+}
+
+bool CustomVarsDataModel::SetValueByRow(wxVariant const & _i_var, unsigned int _i_row, unsigned int _i_col)
+{
+    unsigned int    id  =   Id(_i_row);
+    RowEdit     *   re;
+    //  ............................................................................................
+    if ( ( _i_col == eColKey ) && KeyTaken( wxString( _i_var.GetString() ).Trim(true).Trim(false), id ) )
+        return false;                                                                               // renaming onto another var : rejected
+
+    if ( ( re = EditOf(id) ) == nullptr )
+        return false;
+
+    switch ( _i_col )
+    {
+        case eColActive     :   re->active  =   _i_var.GetBool();   break;
+        case eColKey        :   re->key     =   _i_var.GetString(); break;
+        case eColValue      :   re->value   =   _i_var.GetString(); break;
+        case eColComment    :   re->comment =   _i_var.GetString(); break;
+        default             :   return false;
+    }
+    return true;
+}
+
+CustomVarsDataModel::RowEdit * CustomVarsDataModel::EditOf(unsigned int _i_id)
+{
+    EditMap::iterator       it  =   m_Edits.find(_i_id);
+    CustomVarEntry const *  e;
+    //  ............................................................................................
+    if ( it != m_Edits.end() )
+        return &it->second;
+
+    if ( ( e = BaseEntry(_i_id) ) == nullptr )                                                      // appended rows always have an edit
+        return nullptr;
+
+    RowEdit re = { e->key, false, ( e->var.flags & CompileOptionsBase::eVarActive ) != 0, e->key, e->var.value, e->var.comment };
+
+    return &( m_Edits[_i_id] = re );
+}
+
+void CustomVarsDataModel::Materialize() const
+{
+    if ( ! m_Identity )
+        return;
+
+    m_Ids.resize(m_NextId);                                                                         // no row deleted yet : ids are 0 .. m_NextId - 1
+    for ( unsigned int row = 0 ; row != m_Ids.size() ; row++ )
+        m_Ids[row] = row;
+
+    m_Identity = false;
+}
+
+void CustomVarsDataModel::SortIds() const
+{
+    unsigned int    col =   m_SortCol;
+    bool            asc =   m_SortAscending;
+    //  ............................................................................................
+    m_SortPending = false;
+    Materialize();
+
+    std::stable_sort(m_Ids.begin(), m_Ids.end(), [this, col, asc](unsigned int _i_a, unsigned int _i_b)
+    {
+        int cmp;
+        if ( col == eColActive )
+            cmp = static_cast< int >( CellActive(_i_a) ) - static_cast< int >( CellActive(_i_b) );
+        else
+            cmp = CellText(_i_a, col).CmpNoCase( CellText(_i_b, col) );
+
+        return asc ? ( cmp < 0 ) : ( cmp > 0 );
+    });
+}
+
+bool CustomVarsDataModel::CellActive(unsigned int _i_id) const
+{
+    EditMap::const_iterator it  =   m_Edits.find(_i_id);
+    CustomVarEntry const *  e;
+    //  ............................................................................................
+    if ( it != m_Edits.end() )
+        return it->second.active;
+
+    if ( ( e = BaseEntry(_i_id) ) == nullptr )
+        return false;
+
+    return ( e->var.flags & CompileOptionsBase::eVarActive ) != 0;
+}
+
+wxString const & CustomVarsDataModel::CellText(unsigned int _i_id, unsigned int _i_col) const
+{
+    static wxString const   emptystring;
+    EditMap::const_iterator it  =   m_Edits.find(_i_id);
+    CustomVarEntry const *  e;
+    //  ............................................................................................
+    if ( it != m_Edits.end() )
+    {
+        RowEdit const & re = it->second;
+        return ( _i_col == eColKey ) ? re.key : ( _i_col == eColValue ) ? re.value : re.comment;
+    }
+
+    if ( ( e = BaseEntry(_i_id) ) == nullptr )
+        return emptystring;
+
+    return ( _i_col == eColKey ) ? e->key : ( _i_col == eColValue ) ? e->var.value : e->var.comment;
+}
+//  ................................................................................................    ERG-
 
 /*
     CompilerOptions can exist on 3 different levels :
@@ -258,23 +568,24 @@ CompilerOptionsDlg::CompilerOptionsDlg(wxWindow* parent, CompilerGCC* compiler,
     wxWindow    *   w1          =   XRCCTRL(*this, "tabVars", wxPanel);
     wxSizer     *   bsz         =   w1->GetSizer();
     wxSizerFlags    sizerflags;
-    int             colflags    =   wxDATAVIEW_COL_RESIZABLE | wxDATAVIEW_COL_SORTABLE;
+    int             colflags    =   wxDATAVIEW_COL_RESIZABLE;                                       // sorted by OnVarListHeaderClick(), not by the control
     size_t          idx         =   0;
 
     m_VarsPrevSelModRow         =   wxNOT_FOUND;                                                    // reset at each config invocation
 
-    m_VarsWxCtrl    =   new wxDataViewListCtrl  (w1, wxID_ANY);
-    m_VarsWxModel   =   new wxDataViewListStore ();
+    m_VarsWxCtrl    =   new wxDataViewCtrl      (w1, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxDV_ROW_LINES);
+    m_VarsWxModel   =   new CustomVarsDataModel ();
     m_VarsWxCtrl->AssociateModel(m_VarsWxModel);
+    m_VarsWxModel->DecRef();                                                                        // m_VarsWxCtrl owns it now
 
     wxDataViewRenderer  *   dvr0    =   new wxDataViewToggleRenderer(wxString("bool"), wxDATAVIEW_CELL_ACTIVATABLE , wxDVR_DEFAULT_ALIGNMENT );
-    wxDataViewColumn    *   dvc0    =   new wxDataViewColumn(wxString("Set")    , dvr0, 0,  75, wxALIGN_CENTER, colflags );
+    wxDataViewColumn    *   dvc0    =   new wxDataViewColumn(wxString("Set")    , dvr0, CustomVarsDataModel::eColActive,  75, wxALIGN_CENTER, colflags );
 
     wxDataViewRenderer  *   dvr1    =   new wxDataViewTextRenderer(wxString("string"), wxDATAVIEW_CELL_EDITABLE , wxDVR_DEFAULT_ALIGNMENT );
-    wxDataViewColumn    *   dvc1    =   new wxDataViewColumn(wxString("Key")    , dvr1, 1, 150, wxALIGN_LEFT, colflags);
+    wxDataViewColumn    *   dvc1    =   new wxDataViewColumn(wxString("Key")    , dvr1, CustomVarsDataModel::eColKey   , 150, wxALIGN_LEFT, colflags);
 
     wxDataViewRenderer  *   dvr2    =   new wxDataViewTextRenderer(wxString("string"), wxDATAVIEW_CELL_EDITABLE , wxDVR_DEFAULT_ALIGNMENT );
-    wxDataViewColumn    *   dvc2    =   new wxDataViewColumn(wxString("Value")  , dvr2, 2,  80, wxALIGN_LEFT, colflags);
+    wxDataViewColumn    *   dvc2    =   new wxDataViewColumn(wxString("Value")  , dvr2, CustomVarsDataModel::eColValue ,  80, wxALIGN_LEFT, colflags);
 
     m_VarsWxCtrl->AppendColumn(dvc0);
     m_VarsWxCtrl->AppendColumn(dvc1);
@@ -298,6 +609,7 @@ CompilerOptionsDlg::CompilerOptionsDlg(wxWindow* parent, CompilerGCC* compiler,
 
     Bind(wxEVT_DATAVIEW_ITEM_VALUE_CHANGED  , &CompilerOptionsDlg::OnVarListVarChanged, this);
     Bind(wxEVT_DATAVIEW_SELECTION_CHANGED   , &CompilerOptionsDlg::OnVarListSelChanged, this);
+    Bind(wxEVT_DATAVIEW_COLUMN_HEADER_CLICK , &CompilerOptionsDlg::OnVarListHeaderClick, this);
 
     Bind(wxEVT_TEXT                         , &CompilerOptionsDlg::OnTextEvent, this);
     //  ............................................................................................    ERG-
@@ -571,41 +883,31 @@ void CompilerOptionsDlg::DoFillCompilerPrograms()
 } // DoFillCompilerPrograms
 
 //  ................................................................................................    ERG+
-void CompilerOptionsDlg::WxModelAddVarHelper(bool _i_active, wxString const& _i_key, wxString const& _i_val, wxString const& _i_com)
+int CompilerOptionsDlg::WxCtrlSelectedRow() const
 {
-    wxVector<wxVariant>     row;
+    wxDataViewItem  item    =   m_VarsWxCtrl->GetSelection();
     //  ............................................................................................
-    row.push_back( wxVariant(_i_active) );
-    row.push_back( wxVariant(_i_key)    );
-    row.push_back( wxVariant(_i_val)    );
-    row.push_back( wxVariant(_i_com)    );
-
-    m_VarsWxModel->AppendItem(row);
+    return item.IsOk() ? static_cast< int >( m_VarsWxModel->GetRow(item) ) : wxNOT_FOUND;
 }
 //  ................................................................................................    ERG-
 void CompilerOptionsDlg::DoFillVars()
 {
     const CompileOptionsBase    *   base    =   GetVarsOwner();
     //  ............................................................................................
+    m_VarsWxModel->Attach(base);                                                                    // O(1) : rows are read on demand
+    m_VarsPrevSelModRow = wxNOT_FOUND;
+
     if ( ! base )
         return;
     //  ............................................................................................
     //  TEST
-    ///for ( CustomVarHash::const_iterator * it = base->VarEnumGetFirst(0xffff) ; it != nullptr ; it = base->VarEnumGetNext() )
+    ///for ( CustomVarEntry const & e : base->VarEnum(CompileOptionsBase::eVarAll) )
     ///{
-    ///    printf("CVar [%s]\n"    , (*it)->first         .ToStdString().c_str());
-    ///    printf("     [%s]\n"    , (*it)->second.value  .ToStdString().c_str());
-    ///    printf("     [%s]\n"    , (*it)->second.comment.ToStdString().c_str());
-    ///    printf("     [%08x]\n"  , (*it)->second.flags);
+    ///    printf("CVar [%s]\n"    , e.key        .ToStdString().c_str());
+    ///    printf("     [%s]\n"    , e.var.value  .ToStdString().c_str());
+    ///    printf("     [%s]\n"    , e.var.comment.ToStdString().c_str());
+    ///    printf("     [%08x]\n"  , e.var.flags);
     ///}
-    //  ............................................................................................
-    m_VarsWxModel->DeleteAllItems();
-
-    for ( CustomVarHash::const_iterator * it = base->VarEnumGetFirst(CompileOptionsBase::eVarAll) ; it != nullptr ; it = base->VarEnumGetNext() )
-    {
-        CustomVar cv = (*it)->second;
-        WxModelAddVarHelper(cv.flags & CompileOptionsBase::eVarActive ? true : false, (*it)->first, cv.value, cv.comment);
-    }
 } // DoFillVars
 
 void CompilerOptionsDlg::DoFillOthers()
@@ -1227,29 +1529,84 @@ void CompilerOptionsDlg::DoSaveVars()
     if ( ! base )
         return;
 
-    ///base->UnsetAllVars();
-    base->VarUnsetAll();
-
+    CompileOptionsBase::VarBatch    batch(*base);                                                   // one pass, one modification notification
+    wxString                        selkey;
+    wxVariant                       vk;
+    std::set< unsigned int >        rejected;                                                       // row ids of the rejected renames
+    wxString                        renames;
+    //  ............................................................................................
     //  this save the comment of current selected row if no row selection change has happened
-    int mrow = m_VarsWxCtrl->GetSelectedRow();
+    int mrow = WxCtrlSelectedRow();
     if ( mrow != wxNOT_FOUND )
+    {
         WxModelSaveComment(mrow);
+        m_VarsWxModel->GetValueByRow(vk, mrow, CustomVarsDataModel::eColKey);
+        selkey = vk.GetString().Trim(true).Trim(false);
+    }
 
-    for ( unsigned int ridx = 0 ; ridx != m_VarsWxModel->GetItemCount() ; ridx++ )
+    if ( ! m_VarsWxModel->IsEdited() )                                                              // untouched page : the owner stays unmodified
+        return;
+    //  ............................................................................................
+    //  removals first ( deleted rows, and old keys of renamed rows ), so that a row which got the
+    //  key of a deleted / renamed var is not unset afterwards
+    if ( m_VarsWxModel->IsCleared() )
+        batch.UnsetAll();
+
+    for ( CustomVarsDataModel::EditMap::value_type const & it : m_VarsWxModel->GetEdits() )
     {
-        wxVariant   va, vk, vv, vc;
-        m_VarsWxModel->GetValueByRow(va, ridx, 0);
-        m_VarsWxModel->GetValueByRow(vk, ridx, 1);
-        m_VarsWxModel->GetValueByRow(vv, ridx, 2);
-        m_VarsWxModel->GetValueByRow(vc, ridx, 3);
+        CustomVarsDataModel::RowEdit const & re = it.second;
+        wxString                             key = wxString(re.key).Trim(true).Trim(false);
+
+        if ( re.origKey.IsEmpty() )                                                                 // appended row
+            continue;
 
-        bool        active  = va.GetBool();
-        wxString    key     = vk.GetString().Trim(true).Trim(false);
-        wxString    val     = vv.GetString().Trim(true).Trim(false);
-        wxString    com     = vc.GetString().Trim(true).Trim(false);
+        if ( re.removed )
+        {
+            batch.Unset(re.origKey);
+            continue;
+        }
+
+        if ( key == re.origKey )
+            continue;
 
-        base->VarSet(key, val, com, active ? CompileOptionsBase::eVarActive : CompileOptionsBase::eVarInactive, false);
+        if ( m_VarsWxModel->KeyTaken(key, it.first) )                                               // renamed onto another var : the rename is rejected
+        {
+            rejected.insert(it.first);
+            renames += wxString::Format(_T("\n%s -> %s"), re.origKey, key);
+            continue;
+        }
+
+        batch.Unset(re.origKey);
+    }
+    //  ............................................................................................
+    for ( CustomVarsDataModel::EditMap::value_type const & it : m_VarsWxModel->GetEdits() )
+    {
+        CustomVarsDataModel::RowEdit const & re = it.second;
+
+        if ( re.removed )
+            continue;
+
+        wxString    key     = rejected.count(it.first) ? re.origKey : wxString(re.key).Trim(true).Trim(false);
+        wxString    val     = wxString(re.value  ).Trim(true).Trim(false);
+        wxString    com     = wxString(re.comment).Trim(true).Trim(false);
+
+        batch.Set(key, val, com, re.active ? CompileOptionsBase::eVarActive : CompileOptionsBase::eVarInactive);
     }
+
+    batch.Commit();                                                                                 // notifies only if a var really changed
+
+    if ( ! renames.IsEmpty() )
+    {
+        cbMessageBox(_("These variables were not renamed, a variable with the new name exists :") + renames,
+                     _("Custom variables"), wxOK | wxICON_WARNING);
+    }
+    //  ............................................................................................
+    //  the owner's stores changed, so did the ids of the model's rows
+    m_VarsWxModel->Attach(base);
+
+    m_VarsPrevSelModRow = selkey.IsEmpty() ? wxNOT_FOUND : m_VarsWxModel->FindKey(selkey);
+    if ( m_VarsPrevSelModRow != wxNOT_FOUND )
+        m_VarsWxCtrl->Select( m_VarsWxModel->GetItem(m_VarsPrevSelModRow) );
 } // DoSaveVars
 
 void CompilerOptionsDlg::DoSaveCompilerDefinition()
@@ -2100,7 +2457,7 @@ void CompilerOptionsDlg::OnAddVarClick(cb_unused wxCommandEvent& event)
         key.Trim(true).Trim(false);
         value.Trim(true).Trim(false);
         QuoteString(value, _("Add variable quote string"));
-        WxModelAddVarHelper(true, key, value);
+        m_VarsWxModel->AppendVar(true, key, value, wxString(""));
         m_bDirty = true;
     }
 } // OnAddVarClick
@@ -2111,11 +2468,12 @@ void CompilerOptionsDlg::OnBrowseVarClick(cb_unused wxCommandEvent& event)
     if ( dir.IsEmpty() )
         return;
 
-    int sel = m_VarsWxCtrl->GetSelectedRow();
+    int sel = WxCtrlSelectedRow();
     if ( sel == wxNOT_FOUND )                                                                       // should not happend cf OnUpdateUI()
         return;
 
-    m_VarsWxCtrl->SetTextValue(dir, sel, 2);                                                        // this will update the wxDataViewListStore too
+    m_VarsWxModel->SetValueByRow(dir, sel, CustomVarsDataModel::eColValue);
+    m_VarsWxModel->RowValueChanged(sel, CustomVarsDataModel::eColValue);                            // refresh the control
 
     m_bDirty = true;
 }
@@ -2123,10 +2481,15 @@ void CompilerOptionsDlg::OnBrowseVarClick(cb_unused wxCommandEvent& event)
 void CompilerOptionsDlg::WxModelSaveComment(int _i_row)
 {
     wxString com;
+    wxVariant vc;
     //  ............................................................................................
     com = XRCCTRL(*this, "txtComment", wxTextCtrl)->GetValue();
 
-    m_VarsWxModel->SetValueByRow(com, _i_row, 3);  // store value in the model
+    m_VarsWxModel->GetValueByRow(vc, _i_row, CustomVarsDataModel::eColComment);
+    if ( vc.GetString() == com )                                                                    // do not put an unchanged row in the overlay
+        return;
+
+    m_VarsWxModel->SetValueByRow(com, _i_row, CustomVarsDataModel::eColComment);  // store value in the model
 }
 
 void CompilerOptionsDlg::WxModelShowComment(int _i_row)
@@ -2134,7 +2497,7 @@ void CompilerOptionsDlg::WxModelShowComment(int _i_row)
     wxVariant vc;
     wxString com;
     //  ............................................................................................
-    m_VarsWxModel->GetValueByRow(vc, _i_row, 3);
+    m_VarsWxModel->GetValueByRow(vc, _i_row, CustomVarsDataModel::eColComment);
 
     com= vc.GetString();
 
@@ -2143,7 +2506,7 @@ void CompilerOptionsDlg::WxModelShowComment(int _i_row)
 
 void CompilerOptionsDlg::OnVarListVarChanged(cb_unused wxDataViewEvent& event)
 {
-    m_bDirty = true;
+    m_bDirty = true;                                                                                // the model keeps the edit in its overlay
 }
 
 void CompilerOptionsDlg::OnVarListSelChanged(cb_unused wxDataViewEvent& event)
@@ -2168,21 +2531,57 @@ void CompilerOptionsDlg::OnVarListSelChanged(cb_unused wxDataViewEvent& event)
     //  ............................................................................................
     //  show comment of newly selected row
 
-    //  wxDataViewListCtrl->GetSelectedRow() gives the index * in the model * of the selected row,
-    //  not the the row's visual index in the control ! ...
-    nmrow = m_VarsWxCtrl->GetSelectedRow();
+    nmrow = WxCtrlSelectedRow();
     if ( nmrow == wxNOT_FOUND )                                                                     // this happend when switching target, because
     {                                                                                               //   in that case no row will be selected ;
         XRCCTRL(*this, "txtComment", wxTextCtrl)->Clear();                                          //   so erase the comment.
+        m_VarsPrevSelModRow = wxNOT_FOUND;
         return;
     }
 
-    //  ... so wxDataViewListStore->GetValueByRow() can be used directly on it !
     WxModelShowComment(nmrow);
 
     m_VarsPrevSelModRow = nmrow;                                                                    // memorize the selected model's row
 }
 
+void CompilerOptionsDlg::OnVarListHeaderClick(wxDataViewEvent& event)
+{
+    wxDataViewColumn    *   dvc     =   event.GetDataViewColumn();
+    int                     col     =   dvc ? static_cast< int >( dvc->GetModelColumn() ) : wxNOT_FOUND;
+    bool                    asc     =   true;
+    wxString                selkey;
+    wxVariant               vk;
+    //  ............................................................................................
+    if ( ! dvc )
+        return;
+    //  ............................................................................................
+    //  sorting resets the control, so save the comment and remember the selected var
+    int mrow = WxCtrlSelectedRow();
+    if ( mrow != wxNOT_FOUND )
+    {
+        WxModelSaveComment(mrow);
+        m_VarsWxModel->GetValueByRow(vk, mrow, CustomVarsDataModel::eColKey);
+        selkey = vk.GetString();
+    }
+
+    if ( m_VarsWxModel->GetSortColumn() == col )                                                    // second click on the same column : reverse
+        asc = ! m_VarsWxModel->IsSortAscending();
+
+    for ( unsigned int i = 0 ; i != m_VarsWxCtrl->GetColumnCount() ; i++ )
+        m_VarsWxCtrl->GetColumn(i)->UnsetAsSortKey();
+    dvc->SetSortOrder(asc);                                                                         // header's arrow only
+
+    m_VarsWxModel->Sort(col, asc);
+    //  ............................................................................................
+    m_VarsPrevSelModRow = selkey.IsEmpty() ? wxNOT_FOUND : m_VarsWxModel->FindKey(selkey);
+    if ( m_VarsPrevSelModRow != wxNOT_FOUND )
+    {
+        wxDataViewItem item = m_VarsWxModel->GetItem(m_VarsPrevSelModRow);
+        m_VarsWxCtrl->Select(item);
+        m_VarsWxCtrl->EnsureVisible(item);
+    }
+}
+
 void CompilerOptionsDlg::OnTextEvent(cb_unused wxCommandEvent& event)
 {
     if ( event.GetId() == XRCID("txtComment") )
@@ -2195,7 +2594,7 @@ void CompilerOptionsDlg::OnTextEvent(cb_unused wxCommandEvent& event)
 void CompilerOptionsDlg::OnRemoveVarClick(cb_unused wxCommandEvent& event)
 {
     //  ............................................................................................    ERG+
-    int sel = m_VarsWxCtrl->GetSelectedRow();
+    int sel = WxCtrlSelectedRow();
     if ( sel == wxNOT_FOUND )                                                                       // should not happend cf OnUpdateUI()
         return;
 
@@ -2203,7 +2602,10 @@ void CompilerOptionsDlg::OnRemoveVarClick(cb_unused wxCommandEvent& event)
                     _("Confirmation"),
                     wxYES_NO | wxICON_QUESTION) == wxID_YES)
     {
-        m_VarsWxCtrl->DeleteItem(sel);                                                              // this will update the wxDataViewListStore too
+        m_VarsPrevSelModRow = wxNOT_FOUND;                                                          // rows after sel move up : do not save
+        XRCCTRL(*this, "txtComment", wxTextCtrl)->Clear();                                          //   the comment into another var
+
+        m_VarsWxModel->DeleteRow(sel);
         m_bDirty = true;
     }
     //  ............................................................................................    ERG+
@@ -2216,7 +2618,10 @@ void CompilerOptionsDlg::OnDeleteAllVarsClick(cb_unused wxCommandEvent& event)
                         _("Confirmation"),
                         wxYES | wxNO | wxICON_QUESTION) == wxID_YES)
     {
-        m_VarsWxCtrl->DeleteAllItems();                                                             // this will update the wxDataViewListStore too
+        m_VarsPrevSelModRow = wxNOT_FOUND;
+        XRCCTRL(*this, "txtComment", wxTextCtrl)->Clear();
+
+        m_VarsWxModel->DeleteAll();
         m_bDirty = true;
     }
     //  ............................................................................................    ERG-
@@ -2894,7 +3299,7 @@ void CompilerOptionsDlg::OnUpdateUI(cb_unused wxUpdateUIEvent& event)
     XRCCTRL(*this, "btnBrowseVar"       , wxButton  )->Enable(en);
     XRCCTRL(*this, "btnDeleteVar"       , wxButton  )->Enable(en);
     XRCCTRL(*this, "txtComment"         , wxTextCtrl)->Enable(en);
-    en = ( m_VarsWxModel->GetItemCount() > 0 );
+    en = ( m_VarsWxModel->GetCount() > 0 );
     XRCCTRL(*this, "btnDeleteAllVars"   , wxButton)->Enable(en);
     //  ............................................................................................    ERG+
     // policies
@@ -25,9 +25,9 @@ class wxPropertyGrid;
 class wxPropertyGridEvent;
 class wxUpdateUIEvent;
 //  ................................................................................................    ERG+
-class wxDataViewListCtrl;
-class wxDataViewListStore;
+class wxDataViewCtrl;
 class wxDataViewEvent;
+class CustomVarsDataModel;
 //  ................................................................................................    ERG-
 
 class CompilerOptionsDlg : public cbConfigurationPanel
@@ -46,7 +46,7 @@ class CompilerOptionsDlg : public cbConfigurationPanel
         void DoFillCompilerSets(int compilerIdx);
         void DoFillCompilerPrograms();
         //  ........................................................................................    ERG+
-        void WxModelAddVarHelper(bool _i_active, wxString const& _i_key, wxString const& _i_val, wxString const& _i_com = wxString(""));
+        int  WxCtrlSelectedRow() const;                                                             //!< model's row of the selected item, or wxNOT_FOUND
         //  ........................................................................................    ERG-
         void DoFillVars();
         void DoFillOthers();
@@ -82,8 +82,9 @@ class CompilerOptionsDlg : public cbConfigurationPanel
         void OnBrowseVarClick(wxCommandEvent& event);
         void WxModelSaveComment(int _i_row);
         void WxModelShowComment(int _i_row);
-        void OnVarListVarChanged(wxDataViewEvent&);                                                 //!< a variable was edited from within the wxDataViewListCtrl
+        void OnVarListVarChanged(wxDataViewEvent&);                                                 //!< a variable was edited from within the wxDataViewCtrl
         void OnVarListSelChanged(wxDataViewEvent&);                                                 //!< another variable was selected
+        void OnVarListHeaderClick(wxDataViewEvent&);                                                //!< sort the variables by the clicked column
         void OnTextEvent(wxCommandEvent&);                                                          //!<
         //  ........................................................................................    ERG-
         void OnRemoveVarClick(wxCommandEvent& event);
@@ -128,8 +129,8 @@ class CompilerOptionsDlg : public cbConfigurationPanel
         wxArrayString                m_CompilerOptions;
         wxArrayString                m_ResourceCompilerOptions;
         //  ........................................................................................    ERG+
-        wxDataViewListCtrl      *   m_VarsWxCtrl;
-        wxDataViewListStore     *   m_VarsWxModel;
+        wxDataViewCtrl          *   m_VarsWxCtrl;
+        CustomVarsDataModel     *   m_VarsWxModel;                  //!< owned by m_VarsWxCtrl
         int                         m_VarsPrevSelModRow;            //!< model's row that was selected before the currently selected model's row
         //  ........................................................................................    ERG-
         int                          m_CurrentCompilerIdx;
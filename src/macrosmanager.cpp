@@ -30,6 +30,28 @@
 
 #include <wx/stdpaths.h> // wxStandardPaths
 #include <cstdlib>
+#include <cstdarg>
+#include <cstdio>
+#include <algorithm>
+//  ................................................................................................    ERG+
+#include <chrono>
+#include <wx/ffile.h>
+#include <wx/frame.h>
+
+//  FindDelimiter() vector width, in bytes ; define MACROS_SCAN_SCALAR to measure without
+#if !defined(MACROS_SCAN_SCALAR) && wxUSE_UNICODE_WCHAR
+    #if defined(__AVX2__)
+        #include <immintrin.h>
+        #define MACROS_SCAN_WIDTH   32
+    #elif defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && ( _M_IX86_FP >= 2 ) )
+        #include <emmintrin.h>
+        #define MACROS_SCAN_WIDTH   16
+    #endif
+    #if defined(MACROS_SCAN_WIDTH) && defined(_MSC_VER)
+        #include <intrin.h>                                                                         // _BitScanForward
+    #endif
+#endif
+//  ................................................................................................    ERG-
 
 #include "scripting/sqplus/sqplus.h"
 #include "scripting/bindings/scriptbindings.h"
@@ -46,23 +68,427 @@ static const wxString const_RANDOM(_T("RANDOM"));
 static const wxString toNativePath(_T("$TO_NATIVE_PATH{"));
 static const wxString toUnixPath(_T("$TO_UNIX_PATH{"));
 static const wxString toWindowsPath(_T("$TO_WINDOWS_PATH{"));
+//  ................................................................................................    ERG+
+static const wxString toIf(_T("$if("));
+static const wxString toIfNum(_T("$ifnum("));
+static const wxString toAbsolutePath(_T("$TO_ABSOLUTE_PATH{"));
+static const wxString to83Path(_T("$TO_83_PATH{"));
+static const wxString toRemoveQuotes(_T("$REMOVE_QUOTES{"));
+
+/// Profile names of the constructs, by MacroNode::kind from ePhaseIf.
+static const wxString s_ProfileConstructs[] =
+{
+    _T("$if"), _T("[[script]]"), _T("$TO_ABSOLUTE_PATH"), _T("$TO_83_PATH"), _T("$TO_NATIVE_PATH"),
+    _T("$TO_UNIX_PATH"), _T("$TO_WINDOWS_PATH"), _T("$REMOVE_QUOTES")
+};
+static const wxString s_ProfileGlobal(_T("$#GLOBAL"));                                             // m_UserVarMan->Replace()
+static const wxString s_ProfileEnv(_T("env"));                                                      // environment fallback of the vars
+
+namespace
+{
+/// Builtin macros slots, grouped by layer ; the aliases of a name share its slot.
+enum
+{
+    eSlotAmp                ,                                                                       // eLayerGlobal
+    eSlotAppPath            ,
+    eSlotDataPath           ,
+    eSlotPlugins            ,
+    eSlotLanguage           ,
+    eSlotEncoding           ,
+    eSlotCmdNull            ,
+    eSlotCmdCp              ,
+    eSlotCmdRm              ,
+    eSlotCmdMv              ,
+    eSlotCmdMkdir           ,
+    eSlotCmdRmdir           ,
+    eSlotPlatform           ,
+    eSlotWorkspaceFile      ,
+    eSlotWorkspaceName      ,
+    eSlotWorkspaceDir       ,
+
+    eSlotProjectFile        ,                                                                       // eLayerProject
+    eSlotProjectName        ,
+    eSlotProjectDir         ,
+    eSlotProjectTopDir      ,
+    eSlotMakefile           ,
+    eSlotAllProjectFiles    ,
+
+    eSlotTargetCC           ,                                                                       // eLayerTarget
+    eSlotTargetCPP          ,
+    eSlotTargetLD           ,
+    eSlotTargetLIB          ,
+    eSlotTargetCompilerDir  ,
+    eSlotTargetObjectDir    ,
+    eSlotTargetOutputDir    ,
+    eSlotTargetName         ,
+    eSlotTargetOutputBase   ,
+    eSlotTargetOutputName   ,
+    eSlotTargetOutputFile   ,
+
+    eSlotEditorFilename     ,                                                                       // eLayerEditor
+    eSlotEditorDirname      ,
+    eSlotEditorStem         ,
+    eSlotEditorExt          ,
+    eSlotEditorLine         ,
+    eSlotEditorLine0        ,
+    eSlotEditorColumn       ,
+    eSlotEditorColumn0      ,
+    eSlotEditorSelection    ,
+
+    eSlotDataDir            ,                                                                       // eLayerStdPaths
+    eSlotLocalDataDir       ,
+    eSlotDocumentsDir       ,
+    eSlotConfigDir          ,
+    eSlotUserConfigDir      ,
+    eSlotUserDataDir        ,
+    eSlotUserLocalDataDir   ,
+    eSlotTempDir            ,
+
+    eSlotTday               ,                                                                       // eLayerTime
+    eSlotToday              ,
+    eSlotNow                ,
+    eSlotNowL               ,
+    eSlotWeekday            ,
+    eSlotTdayUtc            ,
+    eSlotTodayUtc           ,
+    eSlotNowUtc             ,
+    eSlotNowLUtc            ,
+    eSlotWeekdayUtc         ,
+    eSlotDaycount           ,
+
+    eSlotCount
+};
+
+struct BuiltinName
+{
+    const wxChar    *   name;
+    int                 slot;
+};
+
+const BuiltinName s_BuiltinNames[] =
+{
+    { _T("AMP")                     , eSlotAmp              },
+    { _T("CODEBLOCKS")              , eSlotAppPath          },
+    { _T("APP_PATH")                , eSlotAppPath          },
+    { _T("APP-PATH")                , eSlotAppPath          },
+    { _T("APPPATH")                 , eSlotAppPath          },
+    { _T("DATA_PATH")               , eSlotDataPath         },
+    { _T("DATA-PATH")               , eSlotDataPath         },
+    { _T("DATAPATH")                , eSlotDataPath         },
+    { _T("PLUGINS")                 , eSlotPlugins          },
+    { _T("LANGUAGE")                , eSlotLanguage         },
+    { _T("ENCODING")                , eSlotEncoding         },
+    { _T("CMD_NULL")                , eSlotCmdNull          },
+    { _T("CMD_CP")                  , eSlotCmdCp            },
+    { _T("CMD_RM")                  , eSlotCmdRm            },
+    { _T("CMD_MV")                  , eSlotCmdMv            },
+    { _T("CMD_MKDIR")               , eSlotCmdMkdir         },
+    { _T("CMD_RMDIR")               , eSlotCmdRmdir         },
+    { _T("PLATFORM")                , eSlotPlatform         },
+    { _T("WORKSPACE_FILE")          , eSlotWorkspaceFile    },
+    { _T("WORKSPACE_FILENAME")      , eSlotWorkspaceFile    },
+    { _T("WORKSPACE_FILE_NAME")     , eSlotWorkspaceFile    },
+    { _T("WORKSPACEFILE")           , eSlotWorkspaceFile    },
+    { _T("WORKSPACEFILENAME")       , eSlotWorkspaceFile    },
+    { _T("WORKSPACENAME")           , eSlotWorkspaceName    },
+    { _T("WORKSPACE_NAME")          , eSlotWorkspaceName    },
+    { _T("WORKSPACE_DIR")           , eSlotWorkspaceDir     },
+    { _T("WORKSPACE_DIRECTORY")     , eSlotWorkspaceDir     },
+    { _T("WORKSPACEDIR")            , eSlotWorkspaceDir     },
+    { _T("WORKSPACEDIRECTORY")      , eSlotWorkspaceDir     },
+
+    { _T("PROJECTFILE")             , eSlotProjectFile      },
+    { _T("PROJECT_FILE")            , eSlotProjectFile      },
+    { _T("PROJECTFILENAME")         , eSlotProjectFile      },
+    { _T("PROJECT_FILENAME")        , eSlotProjectFile      },
+    { _T("PROJECT_FILE_NAME")       , eSlotProjectFile      },
+    { _T("PROJECTNAME")             , eSlotProjectName      },
+    { _T("PROJECT_NAME")            , eSlotProjectName      },
+    { _T("PROJECTDIR")              , eSlotProjectDir       },
+    { _T("PROJECT_DIR")             , eSlotProjectDir       },
+    { _T("PROJECTDIRECTORY")        , eSlotProjectDir       },
+    { _T("PROJECT_DIRECTORY")       , eSlotProjectDir       },
+    { _T("PROJECTTOPDIR")           , eSlotProjectTopDir    },
+    { _T("PROJECT_TOPDIR")          , eSlotProjectTopDir    },
+    { _T("PROJECTTOPDIRECTORY")     , eSlotProjectTopDir    },
+    { _T("PROJECT_TOPDIRECTORY")    , eSlotProjectTopDir    },
+    { _T("MAKEFILE")                , eSlotMakefile         },
+    { _T("ALL_PROJECT_FILES")       , eSlotAllProjectFiles  },
+
+    { _T("TARGET_CC")               , eSlotTargetCC         },
+    { _T("TARGET_CPP")              , eSlotTargetCPP        },
+    { _T("TARGET_LD")               , eSlotTargetLD         },
+    { _T("TARGET_LIB")              , eSlotTargetLIB        },
+    { _T("TARGET_COMPILER_DIR")     , eSlotTargetCompilerDir},
+    { _T("TARGET_OBJECT_DIR")       , eSlotTargetObjectDir  },
+    { _T("TARGET_OUTPUT_DIR")       , eSlotTargetOutputDir  },
+    { _T("TARGET_NAME")             , eSlotTargetName       },
+    { _T("TARGET_OUTPUT_BASENAME")  , eSlotTargetOutputBase },
+    { _T("TARGET_OUTPUT_FILENAME")  , eSlotTargetOutputName },
+    { _T("TARGET_OUTPUT_FILE")      , eSlotTargetOutputFile },
+
+    { _T("ACTIVE_EDITOR_FILENAME")  , eSlotEditorFilename   },
+    { _T("ACTIVE_EDITOR_DIRNAME")   , eSlotEditorDirname    },
+    { _T("ACTIVE_EDITOR_STEM")      , eSlotEditorStem       },
+    { _T("ACTIVE_EDITOR_EXT")       , eSlotEditorExt        },
+    { _T("ACTIVE_EDITOR_LINE")      , eSlotEditorLine       },
+    { _T("ACTIVE_EDITOR_LINE_0")    , eSlotEditorLine0      },
+    { _T("ACTIVE_EDITOR_COLUMN")    , eSlotEditorColumn     },
+    { _T("ACTIVE_EDITOR_COLUMN_0")  , eSlotEditorColumn0    },
+    { _T("ACTIVE_EDITOR_SELECTION") , eSlotEditorSelection  },
+
+    { _T("GET_DATA_DIR")            , eSlotDataDir          },
+    { _T("GET_LOCAL_DATA_DIR")      , eSlotLocalDataDir     },
+    { _T("GET_DOCUMENTS_DIR")       , eSlotDocumentsDir     },
+    { _T("GET_CONFIG_DIR")          , eSlotConfigDir        },
+    { _T("GET_USER_CONFIG_DIR")     , eSlotUserConfigDir    },
+    { _T("GET_USER_DATA_DIR")       , eSlotUserDataDir      },
+    { _T("GET_USER_LOCAL_DATA_DIR") , eSlotUserLocalDataDir },
+    { _T("GET_TEMP_DIR")            , eSlotTempDir          },
+
+    { _T("TDAY")                    , eSlotTday             },
+    { _T("TODAY")                   , eSlotToday            },
+    { _T("NOW")                     , eSlotNow              },
+    { _T("NOW_L")                   , eSlotNowL             },
+    { _T("WEEKDAY")                 , eSlotWeekday          },
+    { _T("TDAY_UTC")                , eSlotTdayUtc          },
+    { _T("TODAY_UTC")               , eSlotTodayUtc         },
+    { _T("NOW_UTC")                 , eSlotNowUtc           },
+    { _T("NOW_L_UTC")               , eSlotNowLUtc          },
+    { _T("WEEKDAY_UTC")             , eSlotWeekdayUtc       },
+    { _T("DAYCOUNT")                , eSlotDaycount         }
+};
+
+const int s_BuiltinCount = sizeof(s_BuiltinNames) / sizeof(s_BuiltinNames[0]);
+
+/// Layer of a slot, from the ranges of the enum.
+int SlotLayer(int _i_slot)
+{
+    if ( _i_slot < eSlotProjectFile )
+        return MacrosManager::eLayerGlobal;
+
+    if ( _i_slot < eSlotTargetCC )
+        return MacrosManager::eLayerProject;
+
+    if ( _i_slot < eSlotEditorFilename )
+        return MacrosManager::eLayerTarget;
+
+    if ( _i_slot < eSlotDataDir )
+        return MacrosManager::eLayerEditor;
+
+    if ( _i_slot < eSlotTday )
+        return MacrosManager::eLayerStdPaths;
+
+    return MacrosManager::eLayerTime;
+}
+
+/** Perfect hash of the builtin names, by hash and displace : a first hash spreads the names
+  * in buckets, each bucket then gets the first seed whose hash sends all its names to free
+  * cells ( the largest buckets are placed first ). The names are fixed and the table is built
+  * once, by the first Builtins() : a C++11 constexpr function ( one return statement ) cannot
+  * fill it, and a generated table would have to follow s_BuiltinNames by hand. A lookup is two
+  * hashes and at most one compare.
+  */
+class BuiltinIndex
+{
+    public:
+        BuiltinIndex()
+            :   m_MaxLen(0)
+        {
+            std::vector< std::vector< int > >   buckets;
+            std::vector< int >                  order;
+            size_t                              size    =   1;
+            //  ....................................................................................
+            while ( size < s_BuiltinCount + s_BuiltinCount / 4 )
+                size <<= 1;
+            m_Mask          =   size - 1;
+            m_BucketMask    =   ( size / 4 ) - 1;
+
+            m_Table.assign(size, -1);
+            m_Seeds.assign(m_BucketMask + 1, 0);
+            buckets.resize(m_BucketMask + 1);
+
+            for ( int k = 0 ; k < s_BuiltinCount ; k++ )
+            {
+                wxString name(s_BuiltinNames[k].name);
+
+                m_MaxLen = std::max( m_MaxLen, name.length() );
+                buckets[ Hash(name, 0) & m_BucketMask ].push_back(k);
+            }
+
+            for ( size_t b = 0 ; b < buckets.size() ; b++ )
+                order.push_back( static_cast< int >(b) );
+            std::stable_sort( order.begin(), order.end(), [&buckets](int a, int b) { return buckets[a].size() > buckets[b].size(); } );
+
+            for ( int b : order )
+            {
+                std::vector< int > const &  names   =   buckets[b];
+                std::vector< size_t >       cells;
+
+                for ( unsigned seed = 1 ; ! names.empty() ; seed++ )
+                {
+                    cells.clear();
+                    for ( int k : names )
+                    {
+                        size_t cell = Hash(s_BuiltinNames[k].name, seed) & m_Mask;
+
+                        if ( ( m_Table[cell] >= 0 ) || ( std::find(cells.begin(), cells.end(), cell) != cells.end() ) )
+                            break;
+                        cells.push_back(cell);
+                    }
+                    if ( cells.size() < names.size() )
+                        continue;
+
+                    for ( size_t n = 0 ; n < names.size() ; n++ )
+                        m_Table[ cells[n] ] = names[n];
+                    m_Seeds[b] = seed;
+                    break;
+                }
+            }
+        }
+
+        /// Slot of an upper-cased name, -1 if not a builtin.
+        int     Find(wxString const & _i_upper) const
+        {
+            size_t  len     =   _i_upper.length();
+            int     k;
+            //  ....................................................................................
+            if ( ( len == 0 ) || ( len > m_MaxLen ) )
+                return -1;
+
+            k = m_Table[ Hash(_i_upper, m_Seeds[ Hash(_i_upper, 0) & m_BucketMask ]) & m_Mask ];
+
+            return ( ( k >= 0 ) && ( _i_upper.compare(s_BuiltinNames[k].name) == 0 ) ) ? s_BuiltinNames[k].slot : -1;
+        }
+
+    private:
+        static unsigned Hash(wxString const & _i_s, unsigned _i_seed)
+        {
+            unsigned h = 2166136261u ^ ( _i_seed * 0x9e3779b9u );
+            //  ....................................................................................
+            for ( size_t i = 0 ; i < _i_s.length() ; i++ )
+            {
+                wxChar c = _i_s[i];
+                h = ( h ^ static_cast< unsigned >( c ) ) * 16777619u;
+            }
+
+            return h ^ ( h >> 15 );
+        }
+
+        std::vector< int >      m_Table;                                                            //!< index in s_BuiltinNames, -1 if free
+        std::vector< unsigned > m_Seeds;                                                            //!< per bucket
+        size_t                  m_Mask;
+        size_t                  m_BucketMask;
+        size_t                  m_MaxLen;
+};
+
+BuiltinIndex const & Builtins()
+{
+    static const BuiltinIndex index;
+    //  ............................................................................................
+    return index;
+}
+} // namespace
+//  ................................................................................................    ERG-
 
 MacrosManager::MacrosManager()
+    //  ............................................................................................    ERG+
+    : m_MacrosStamp(0), m_Slots(eSlotCount), m_SlotSet(eSlotCount, false), m_SlotLazy(eSlotCount, false),
+      m_Templates(1024), m_DepsIndexLive(0), m_ResultsStamp(0), m_ResultsExternalGen(0), m_Deps(nullptr),
+      m_ResolvedStamp(0), m_ResolveTaint(0), m_EnvGeneration(0), m_ScriptsStamp(0),
+      m_Profile(false), m_ProfileEvaluations(0), m_ProfileMenu(nullptr)
+    //  ............................................................................................    ERG-
 {
+    //  ............................................................................................    ERG+
+    for ( int layer = 0 ; layer < eLayerCount ; layer++ )
+        m_MacrosOwnerGen[layer] = 0;
+    ResetCounters();
+    Manager::Get()->RegisterEventSink(cbEVT_COMPILER_STARTED , new cbEventFunctor<MacrosManager, CodeBlocksEvent>(this, &MacrosManager::OnCompilerStarted ));
+    Manager::Get()->RegisterEventSink(cbEVT_COMPILER_FINISHED, new cbEventFunctor<MacrosManager, CodeBlocksEvent>(this, &MacrosManager::OnCompilerFinished));
+    CompileOptionsBase::SetVarsListener(&MacrosManager::OnVarsModified);
+    //  ............................................................................................    ERG-
     Reset();
 }
 
 MacrosManager::~MacrosManager()
 {
+    //  ............................................................................................    ERG+
+    Manager::Get()->RemoveAllEventSinksFor(this);
+    CompileOptionsBase::SetVarsListener(nullptr);                                                   // the var edits of the shutdown
+    delete m_ProfileMenu;
+    //  ............................................................................................    ERG-
 }
 
-void MacrosManager::CreateMenu(cb_unused wxMenuBar* menuBar)
+//  ................................................................................................    ERG+
+namespace
+{
+const long idMacrosProfile      =   wxNewId();
+const long idMacrosProfileDump  =   wxNewId();
+
+/// The Tools menu entries of the profile : MacrosManager is no event handler.
+class ProfileMenu : public wxEvtHandler
+{
+    public:
+        void    OnToggle    (wxCommandEvent & _i_event)     {   Manager::Get()->GetMacrosManager()->ProfileEnable(_i_event.IsChecked());  }
+        void    OnDump      (cb_unused wxCommandEvent & _i_event)
+        {
+            if ( ! Manager::Get()->GetMacrosManager()->ProfileDump() )
+                cbMessageBox(_("The macros profile could not be written."), _("Error"), wxICON_ERROR);
+        }
+};
+} // namespace
+//  ................................................................................................    ERG-
+
+//  ................................................................................................    ERG+
+//  ERG void MacrosManager::CreateMenu(cb_unused wxMenuBar* menuBar)
+//  ERG {
+//  ERG }
+void MacrosManager::CreateMenu(wxMenuBar* menuBar)
 {
+    wxFrame *   frame   =   Manager::Get()->GetAppFrame();
+    int         pos     =   menuBar ? menuBar->FindMenu(_("&Tools")) : wxNOT_FOUND;
+    //  ............................................................................................
+    if ( ( pos == wxNOT_FOUND ) || ! frame || m_ProfileMenu )
+        return;
+
+    wxMenu * tools = menuBar->GetMenu(pos);
+
+    tools->AppendSeparator();
+    tools->AppendCheckItem(idMacrosProfile, _("Profile macros expansion"), _("Count and time the expansions of each macro and construct"));
+    tools->Append(idMacrosProfileDump, _("Dump macros profile"), _("Write the macros profile as JSON into the config folder"));
+    tools->Check(idMacrosProfile, m_Profile);
+
+    m_ProfileMenu = new ProfileMenu;
+    frame->Connect(idMacrosProfile    , wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ProfileMenu::OnToggle), nullptr, m_ProfileMenu);
+    frame->Connect(idMacrosProfileDump, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ProfileMenu::OnDump)  , nullptr, m_ProfileMenu);
 }
 
-void MacrosManager::ReleaseMenu(cb_unused wxMenuBar* menuBar)
+//  ERG void MacrosManager::ReleaseMenu(cb_unused wxMenuBar* menuBar)
+//  ERG {
+//  ERG }
+void MacrosManager::ReleaseMenu(wxMenuBar* menuBar)
 {
+    wxFrame *   frame   =   Manager::Get()->GetAppFrame();
+    wxMenu  *   menu    =   nullptr;
+    //  ............................................................................................
+    if ( ! m_ProfileMenu )
+        return;
+
+    if ( frame )
+    {
+        frame->Disconnect(idMacrosProfile    , wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ProfileMenu::OnToggle), nullptr, m_ProfileMenu);
+        frame->Disconnect(idMacrosProfileDump, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ProfileMenu::OnDump)  , nullptr, m_ProfileMenu);
+    }
+    if ( menuBar && menuBar->FindItem(idMacrosProfile, &menu) && menu )
+    {
+        menu->Destroy(idMacrosProfile);
+        menu->Destroy(idMacrosProfileDump);
+    }
+
+    delete m_ProfileMenu;
+    m_ProfileMenu = nullptr;
 }
+//  ................................................................................................    ERG-
 
 wxString MacrosManager::ReplaceMacros(const wxString& buffer, const ProjectBuildTarget* target)
 {
@@ -83,74 +509,81 @@ void MacrosManager::Reset()
     m_Plugins  = UnixFilename(ConfigManager::GetPluginsFolder());
     m_DataPath = UnixFilename(ConfigManager::GetDataFolder());
     ClearProjectKeys();
-    m_RE_Unix.Compile(_T("([^$]|^)(\\$[({]?(#?[A-Za-z_0-9.]+)[)} /\\]?)"),               wxRE_EXTENDED | wxRE_NEWLINE);
-    m_RE_DOS.Compile(_T("([^%]|^)(%(#?[A-Za-z_0-9.]+)%)"),                               wxRE_EXTENDED | wxRE_NEWLINE);
-    m_RE_If.Compile(_T("\\$if\\(([^)]*)\\)[::space::]*(\\{([^}]*)\\})(\\{([^}]*)\\})?"), wxRE_EXTENDED | wxRE_NEWLINE);
-    m_RE_IfSp.Compile(_T("[^=!<>]+|(([^=!<>]+)[ ]*(=|==|!=|>|<|>=|<=)[ ]*([^=!<>]+))"),  wxRE_EXTENDED | wxRE_NEWLINE);
-    m_RE_Script.Compile(_T("(\\[\\[(.*)\\]\\])"),                                        wxRE_EXTENDED | wxRE_NEWLINE);
-    m_RE_ToAbsolutePath.Compile(_T("\\$TO_ABSOLUTE_PATH{([^}]*)}"),
-#ifndef __WXMAC__
-                                wxRE_ADVANCED);
-#else
-                                wxRE_EXTENDED);
-#endif
-    m_RE_To83Path.Compile(_T("\\$TO_83_PATH{([^}]*)}"),
-#ifndef __WXMAC__
-                                wxRE_ADVANCED);
-#else
-                                wxRE_EXTENDED);
-#endif
-    m_RE_RemoveQuotes.Compile(_T("\\$REMOVE_QUOTES{([^}]*)}"),
-#ifndef __WXMAC__
-                                wxRE_ADVANCED);
-#else
-                                wxRE_EXTENDED);
-#endif
+    //  ............................................................................................    ERG+
+    //  ERG the constructs and the $if conditions are parsed by CompileRange()
+    //  ERG m_RE_Unix.Compile(_T("([^$]|^)(\\$[({]?(#?[A-Za-z_0-9.]+)[)} /\\]?)"),               wxRE_EXTENDED | wxRE_NEWLINE);
+    //  ERG m_RE_DOS.Compile(_T("([^%]|^)(%(#?[A-Za-z_0-9.]+)%)"),                               wxRE_EXTENDED | wxRE_NEWLINE);
+    //  ERG m_RE_If.Compile(_T("\\$if\\(([^)]*)\\)[::space::]*(\\{([^}]*)\\})(\\{([^}]*)\\})?"), wxRE_EXTENDED | wxRE_NEWLINE);
+    //  ERG m_RE_IfSp.Compile(_T("[^=!<>]+|(([^=!<>]+)[ ]*(=|==|!=|>|<|>=|<=)[ ]*([^=!<>]+))"),  wxRE_EXTENDED | wxRE_NEWLINE);
+    //  ERG m_RE_Script.Compile(_T("(\\[\\[(.*)\\]\\])"),                                        wxRE_EXTENDED | wxRE_NEWLINE);
+    //  ERG m_RE_ToAbsolutePath.Compile(_T("\\$TO_ABSOLUTE_PATH{([^}]*)}"),
+    //  ERG #ifndef __WXMAC__
+    //  ERG                             wxRE_ADVANCED);
+    //  ERG #else
+    //  ERG                             wxRE_EXTENDED);
+    //  ERG #endif
+    //  ERG m_RE_To83Path.Compile(_T("\\$TO_83_PATH{([^}]*)}"),
+    //  ERG #ifndef __WXMAC__
+    //  ERG                             wxRE_ADVANCED);
+    //  ERG #else
+    //  ERG                             wxRE_EXTENDED);
+    //  ERG #endif
+    //  ERG m_RE_RemoveQuotes.Compile(_T("\\$REMOVE_QUOTES{([^}]*)}"),
+    //  ERG #ifndef __WXMAC__
+    //  ERG                             wxRE_ADVANCED);
+    //  ERG #else
+    //  ERG                             wxRE_EXTENDED);
+    //  ERG #endif
+    //  ............................................................................................    ERG-
     m_UserVarMan = Manager::Get()->GetUserVariableManager();
     srand(time(nullptr));
-    assert(m_RE_Unix.IsValid());
-    assert(m_RE_DOS.IsValid());
+    //  ............................................................................................    ERG+
+    //  ERG assert(m_RE_Unix.IsValid());
+    //  ERG assert(m_RE_DOS.IsValid());
+    //  ERG assert(m_RE_IfSp.IsValid());
+    //  ............................................................................................    ERG-
 }
 
 void MacrosManager::ClearProjectKeys()
 {
-    m_Macros.clear();
+    //  ............................................................................................    ERG+
+    //  ERG m_Macros.clear();
+    for ( int layer = eLayerProject ; layer <= eLayerTarget ; layer++ )
+        LayerInvalidate(layer);
 
-    m_Macros[_T("AMP")]        = _T("&");
-    m_Macros[_T("CODEBLOCKS")] = m_AppPath;
-    m_Macros[_T("APP_PATH")]   = m_AppPath;
-    m_Macros[_T("APP-PATH")]   = m_AppPath;
-    m_Macros[_T("APPPATH")]    = m_AppPath;
-    m_Macros[_T("DATA_PATH")]  = m_DataPath;
-    m_Macros[_T("DATA-PATH")]  = m_DataPath;
-    m_Macros[_T("DATAPATH")]   = m_DataPath;
-    m_Macros[_T("PLUGINS")]    = m_Plugins;
-    m_Macros[_T("LANGUAGE")]   = wxLocale::GetLanguageName(wxLocale::GetSystemLanguage());
-    m_Macros[_T("ENCODING")]   = wxLocale::GetSystemEncodingName();
+    LayerRebuild(eLayerGlobal);                                                                     // the aliases share their slot
+    //  ............................................................................................    ERG-
+
+    SlotSet(eSlotAmp        , _T("&"));
+    SlotSet(eSlotAppPath    , m_AppPath);
+    SlotSet(eSlotDataPath   , m_DataPath);
+    SlotSet(eSlotPlugins    , m_Plugins);
+    SlotSet(eSlotLanguage   , wxLocale::GetLanguageName(wxLocale::GetSystemLanguage()));
+    SlotSet(eSlotEncoding   , wxLocale::GetSystemEncodingName());
 
     if (platform::windows)
     {
-        m_Macros[_T("CMD_NULL")]  = _T("NUL");
+        SlotSet(eSlotCmdNull , _T("NUL"));
 
         const wxString cmd(_T("cmd /c "));
-        m_Macros[_T("CMD_CP")]    = cmd + _T("copy");
-        m_Macros[_T("CMD_RM")]    = cmd + _T("del");
-        m_Macros[_T("CMD_MV")]    = cmd + _T("move");
-        m_Macros[_T("CMD_MKDIR")] = cmd + _T("md");
-        m_Macros[_T("CMD_RMDIR")] = cmd + _T("rd");
+        SlotSet(eSlotCmdCp   , cmd + _T("copy"));
+        SlotSet(eSlotCmdRm   , cmd + _T("del"));
+        SlotSet(eSlotCmdMv   , cmd + _T("move"));
+        SlotSet(eSlotCmdMkdir, cmd + _T("md"));
+        SlotSet(eSlotCmdRmdir, cmd + _T("rd"));
 
-        m_Macros[_T("PLATFORM")] = _T("msw");
+        SlotSet(eSlotPlatform, _T("msw"));
     }
     else
     {
-        m_Macros[_T("CMD_CP")]     = _T("cp --preserve=timestamps");
-        m_Macros[_T("CMD_RM")]     = _T("rm");
-        m_Macros[_T("CMD_MV")]     = _T("mv");
-        m_Macros[_T("CMD_NULL")]   = _T("/dev/null");
-        m_Macros[_T("CMD_MKDIR")]  = _T("mkdir -p");
-        m_Macros[_T("CMD_RMDIR")]  = _T("rmdir");
-
-        m_Macros[_T("PLATFORM")] = _T("unix");
+        SlotSet(eSlotCmdCp   , _T("cp --preserve=timestamps"));
+        SlotSet(eSlotCmdRm   , _T("rm"));
+        SlotSet(eSlotCmdMv   , _T("mv"));
+        SlotSet(eSlotCmdNull , _T("/dev/null"));
+        SlotSet(eSlotCmdMkdir, _T("mkdir -p"));
+        SlotSet(eSlotCmdRmdir, _T("rmdir"));
+
+        SlotSet(eSlotPlatform, _T("unix"));
     }
 
     cbWorkspace* wksp = Manager::Get()->GetProjectManager()->GetWorkspace();
@@ -168,17 +601,9 @@ void MacrosManager::ClearProjectKeys()
         m_WorkspaceName = wxEmptyString;
         m_WorkspaceDir = wxEmptyString;
     }
-    m_Macros[_T("WORKSPACE_FILE")]      = m_WorkspaceFilename;
-    m_Macros[_T("WORKSPACE_FILENAME")]  = m_WorkspaceFilename;
-    m_Macros[_T("WORKSPACE_FILE_NAME")] = m_WorkspaceFilename;
-    m_Macros[_T("WORKSPACEFILE")]       = m_WorkspaceFilename;
-    m_Macros[_T("WORKSPACEFILENAME")]   = m_WorkspaceFilename;
-    m_Macros[_T("WORKSPACENAME")]       = m_WorkspaceName;
-    m_Macros[_T("WORKSPACE_NAME")]      = m_WorkspaceName;
-    m_Macros[_T("WORKSPACE_DIR")]       = m_WorkspaceDir;
-    m_Macros[_T("WORKSPACE_DIRECTORY")] = m_WorkspaceDir;
-    m_Macros[_T("WORKSPACEDIR")]        = m_WorkspaceDir;
-    m_Macros[_T("WORKSPACEDIRECTORY")]  = m_WorkspaceDir;
+    SlotSet(eSlotWorkspaceFile, m_WorkspaceFilename);
+    SlotSet(eSlotWorkspaceName, m_WorkspaceName);
+    SlotSet(eSlotWorkspaceDir , m_WorkspaceDir);
 }
 
 wxString GetSelectedText()
@@ -220,39 +645,315 @@ void ReadMacros(MacrosMap &macros, T *object)
         //  ERG for (CustomVarHash::const_iterator it = v.begin(); it != v.end(); ++it)
         //  ERG     macros[it->first.Upper()] = it->second.value;
 
-        for ( CustomVarHash::const_iterator * it = object->VarEnumGetFirst() ; it != nullptr ; it = object->VarEnumGetNext() )
-            macros[ (*it)->first.Upper()] = (*it)->second.value;
+        for ( CustomVarEntry const & e : object->VarEnum() )
+            macros[e.keyUpper] = e.var.value;
         //  ........................................................................................    ERG-
     }
 }
 } // namespace
+//  ................................................................................................    ERG+
+void MacrosManager::SlotSet(int _i_slot, wxString const & _i_value)
+{
+    m_Slots   [_i_slot] = _i_value;
+    m_SlotSet [_i_slot] = true;
+    m_SlotLazy[_i_slot] = false;
+}
 
-void MacrosManager::RecalcVars(const cbProject* project, EditorBase* editor, const ProjectBuildTarget* target)
+void MacrosManager::SlotLazy(int _i_first, int _i_last)
 {
-    m_ActiveEditorFilename = wxEmptyString; // invalidate
-    m_ActiveEditorLine     = -1;            // invalidate
-    m_ActiveEditorColumn   = -1;            // invalidate
+    for ( int slot = _i_first ; slot <= _i_last ; slot++ )
+    {
+        m_SlotSet [slot] = true;
+        m_SlotLazy[slot] = true;
+    }
+}
+
+wxString const & MacrosManager::SlotGet(int _i_slot) const
+{
+    if ( m_SlotLazy[_i_slot] )
+        SlotFetch(_i_slot);
+
+    return m_Slots[_i_slot];
+}
+
+void MacrosManager::SlotFetch(int _i_slot) const
+{
+    ++m_Counters.builtinFetches;
+    m_SlotLazy[_i_slot] = false;
 
-    // Remove all variables for the old target from the macro map. This makes sure that target
-    // specific variables are reinitialized after every target in a multi target project, where
-    // targets are built one after the other. Also if a variable is not set in a target it won't
-    // be visible because it was set by a previous target in the build order.
-    if (m_LastTarget)
+    switch ( _i_slot )
     {
-        //  ........................................................................................    ERG+
-        //  ERG const StringHash& v = m_LastTarget->GetAllVars();
-        //  ERG for (StringHash::const_iterator it = v.begin(); it != v.end(); ++it)
-        //  ERG     m_Macros.erase(it->first.Upper());
+        case eSlotEditorLine    :                                                                   // the position is read once for the four
+        case eSlotEditorLine0   :
+        case eSlotEditorColumn  :
+        case eSlotEditorColumn0 :
+        {
+            EditorBase  *   editor  =   Manager::Get()->GetEditorManager()->GetActiveEditor();
+            int             line    =   -1;
+            int             column  =   -1;
+            wxString        temp_str;
+            //  ....................................................................................
+            //  the editor RecalcVars() saw : the pointer is not kept, it may be the same even
+            //  after closing one file and opening a new one
+            if ( editor && ! m_ActiveEditorFilename.IsEmpty() && ( editor->GetFilename() == m_ActiveEditorFilename ) )
+            {
+                // (re-) compute column and line but only in case it's a builtin-editor
+                if (editor->IsBuiltinEditor())
+                {
+                    cbEditor*         cbEd  = static_cast<cbEditor*>(editor);
+                    cbStyledTextCtrl* cbSTC = cbEd->GetControl();
+                    if (cbSTC)
+                    {
+                        line = cbSTC->GetCurrentLine() + 1;
+                        int pos = cbSTC->GetCurrentPos();
+                        if (pos!=-1)
+                            column = cbSTC->GetColumn(pos) + 1;
+                    }
+                }
+            }
 
-        //  ERG const CustomVarHash& v = m_LastTarget->GetAllVars();
-        //  ERG for (CustomVarHash::const_iterator it = v.begin(); it != v.end(); ++it)
-        //  ERG     m_Macros.erase(it->first.Upper());
+            temp_str.Printf(_T("%d"), line);
+            m_Slots[eSlotEditorLine]    = temp_str;
+            temp_str.Printf(_T("%d"), (line>0) ? line-1 : -1); // zero based, but keep value for "invalid"
+            m_Slots[eSlotEditorLine0]   = temp_str;
+            temp_str.Printf(_T("%d"), column);
+            m_Slots[eSlotEditorColumn]  = temp_str;
+            temp_str.Printf(_T("%d"), (column>0) ? column-1 : -1); // zero based, but keep value for "invalid"
+            m_Slots[eSlotEditorColumn0] = temp_str;
+
+            for ( int slot = eSlotEditorLine ; slot <= eSlotEditorColumn0 ; slot++ )
+                m_SlotLazy[slot] = false;
+            break;
+        }
 
-        for ( CustomVarHash::const_iterator * it = m_LastTarget->VarEnumGetFirst() ; it != nullptr ; it = m_LastTarget->VarEnumGetNext() )
-            m_Macros.erase((*it)->first.Upper());
-        //  ........................................................................................    ERG-
+        case eSlotEditorSelection :
+            m_Slots[eSlotEditorSelection] = GetSelectedText();
+            break;
+
+        // Wrapper for WX standard path's methods:
+
+        // Unix: prefix/share/appname   Windows: EXE path
+        case eSlotDataDir           :   m_Slots[_i_slot] = ((const wxStandardPaths&)wxStandardPaths::Get()).GetDataDir();           break;
+        // Unix: /etc/appname   Windows: EXE path
+        case eSlotLocalDataDir      :   m_Slots[_i_slot] = ((const wxStandardPaths&)wxStandardPaths::Get()).GetLocalDataDir();      break;
+        // Unix: ~   Windows: C:\Documents and Settings\username\Documents
+        case eSlotDocumentsDir      :   m_Slots[_i_slot] = ((const wxStandardPaths&)wxStandardPaths::Get()).GetDocumentsDir();      break;
+        // Unix: /etc   Windows: C:\Documents and Settings\All Users\Application Data
+        case eSlotConfigDir         :   m_Slots[_i_slot] = ((const wxStandardPaths&)wxStandardPaths::Get()).GetConfigDir();         break;
+        // Unix: ~   Windows: C:\Documents and Settings\username\Application Data\appname
+        case eSlotUserConfigDir     :   m_Slots[_i_slot] = ((const wxStandardPaths&)wxStandardPaths::Get()).GetUserConfigDir();     break;
+        // Unix: ~/.appname   Windows: C:\Documents and Settings\username\Application Data
+        case eSlotUserDataDir       :   m_Slots[_i_slot] = ((const wxStandardPaths&)wxStandardPaths::Get()).GetUserDataDir();       break;
+        // Unix: ~/.appname   Windows: C:\Documents and Settings\username\Local Settings\Application Data\appname
+        case eSlotUserLocalDataDir  :   m_Slots[_i_slot] = ((const wxStandardPaths&)wxStandardPaths::Get()).GetUserLocalDataDir();  break;
+        // ALl platforms: A writable, temporary directory
+        case eSlotTempDir           :   m_Slots[_i_slot] = ((const wxStandardPaths&)wxStandardPaths::Get()).GetTempDir();           break;
+
+        default :                                                                                   // eLayerTime : one date for all of them
+        {
+            wxDateTime now(wxDateTime::Now());
+
+            m_Slots[eSlotTday]          = now.Format(_T("%Y%m%d"));
+            m_Slots[eSlotToday]         = now.Format(_T("%Y-%m-%d"));
+            m_Slots[eSlotNow]           = now.Format(_T("%Y-%m-%d-%H.%M"));
+            m_Slots[eSlotNowL]          = now.Format(_T("%Y-%m-%d-%H.%M.%S"));
+            m_Slots[eSlotWeekday]       = now.Format(_T("%A"));
+
+            wxDateTime nowGMT(now.ToGMT());
+            m_Slots[eSlotTdayUtc]       = nowGMT.Format(_T("%Y%m%d"));
+            m_Slots[eSlotTodayUtc]      = nowGMT.Format(_T("%Y-%m-%d"));
+            m_Slots[eSlotNowUtc]        = nowGMT.Format(_T("%Y-%m-%d-%H.%M"));
+            m_Slots[eSlotNowLUtc]       = nowGMT.Format(_T("%Y-%m-%d-%H.%M.%S"));
+            m_Slots[eSlotWeekdayUtc]    = nowGMT.Format(_T("%A"));
+
+            wxDateTime january_1_2010(1, wxDateTime::Jan, 2010, 0, 0, 0, 0);
+            wxTimeSpan ts = now.Subtract(january_1_2010);
+            m_Slots[eSlotDaycount]      = wxString::Format(_T("%d"), ts.GetDays());
+
+            for ( int slot = eSlotTday ; slot <= eSlotDaycount ; slot++ )
+                m_SlotLazy[slot] = false;
+            break;
+        }
+    }
+}
+
+MacrosMap & MacrosManager::LayerRebuild(int _i_layer, CompileOptionsBase const * _i_owner, unsigned long _i_owner_gen)
+{
+    MacrosLayer & l = m_Layers[_i_layer];
+    //  ............................................................................................
+    for ( int slot = 0 ; slot < eSlotCount ; slot++ )
+        if ( SlotLayer(slot) == _i_layer )
+        {
+            m_SlotSet [slot] = false;
+            m_SlotLazy[slot] = false;
+        }
+
+    l.macros.clear();
+    l.owner     =   _i_owner;
+    l.ownerGen  =   _i_owner_gen;
+    l.valid     =   true;
+    l.view      =   false;
+    ++l.generation;
+
+    return l.macros;
+}
+
+void MacrosManager::LayerInvalidate(int _i_layer)
+{
+    MacrosLayer & l = m_Layers[_i_layer];
+    //  ............................................................................................
+    for ( int slot = 0 ; slot < eSlotCount ; slot++ )
+        if ( SlotLayer(slot) == _i_layer )
+        {
+            m_SlotSet [slot] = false;
+            m_SlotLazy[slot] = false;
+        }
+
+    l.macros.clear();
+    l.owner     =   nullptr;
+    l.ownerGen  =   0;
+    l.valid     =   false;
+    l.view      =   false;
+    ++l.generation;
+}
+
+bool MacrosManager::LayerIsUpToDate(int _i_layer, CompileOptionsBase const * _i_owner, unsigned long _i_owner_gen) const
+{
+    MacrosLayer const & l = m_Layers[_i_layer];
+    //  ............................................................................................
+    return ( l.valid && ( l.owner == _i_owner ) && ( l.ownerGen == _i_owner_gen ) );
+}
+
+void MacrosManager::LayerBindVars(int _i_layer, CompileOptionsBase const * _i_owner)
+{
+    unsigned long   gen     =   _i_owner ? _i_owner->GetGeneration() : 0;
+    //  ............................................................................................
+    //  nothing is read : lookups go straight to the owner, so that switching target only swaps
+    //  this pointer. The generation still moves with the owner's one, for GetMacros().
+    if ( LayerIsUpToDate(_i_layer, _i_owner, gen) )
+        return;
+
+    LayerRebuild(_i_layer, _i_owner, gen);
+    m_Layers[_i_layer].view = true;
+}
+
+bool MacrosManager::LayersAreStale(cbProject const * _i_project, ProjectBuildTarget const * _i_target) const
+{
+    MacrosLayer const & cl = m_Layers[eLayerCompilerVars];
+    //  ............................................................................................
+    //  vars edits are seen through the views without any recalculation, but the project and
+    //  target builtins ( outputs, titles, compiler programs ) depend on the owners' options
+    //  generations ( var edits excluded )
+    if ( _i_project && ( _i_project->GetOptionsGeneration() != m_Layers[eLayerProject].ownerGen ) )
+        return true;
+
+    if ( _i_target  && ( _i_target ->GetOptionsGeneration() + ( cl.owner ? cl.owner->GetOptionsGeneration() : 0 ) != m_Layers[eLayerTarget].ownerGen ) )
+        return true;
+
+    return false;
+}
+
+wxString const * MacrosManager::FindMacro(wxString const & _i_upper_key, int * _o_layer) const
+{
+    const int   slot        =   Builtins().Find(_i_upper_key);
+    const int   slotLayer   =   ( slot >= 0 ) ? SlotLayer(slot) : -1;
+    //  ............................................................................................
+    for ( int layer = eLayerCount - 1 ; layer >= 0 ; layer-- )
+    {
+        MacrosLayer const & l = m_Layers[layer];
+
+        if ( _o_layer )
+            *_o_layer = layer;
+
+        if ( l.view )
+        {
+            CustomVarEntry const * e = l.owner ? l.owner->VarFindActiveUpper(_i_upper_key) : nullptr;
+
+            if ( e )
+                return &e->var.value;
+            continue;
+        }
+
+        if ( ( layer == slotLayer ) && m_SlotSet[slot] )
+            return &SlotGet(slot);
+
+        if ( l.macros.empty() )                                                                     // most layers only have slots
+            continue;
+
+        MacrosMap::const_iterator it = l.macros.find(_i_upper_key);
+
+        if ( it != l.macros.end() )
+            return &it->second;
+    }
+
+    return nullptr;
+}
+
+const MacrosMap& MacrosManager::GetMacros() const
+{
+    unsigned long   stamp   =   0;
+    bool            edited  =   false;                                                              // a viewed owner changed since the last merge
+    //  ............................................................................................
+    for ( int layer = 0 ; layer < eLayerCount ; layer++ )
+    {
+        MacrosLayer const & l = m_Layers[layer];
+
+        stamp += l.generation;
+        if ( l.view && l.owner && ( l.owner->GetGeneration() != m_MacrosOwnerGen[layer] ) )
+            edited = true;
+    }
+    for ( int slot = 0 ; slot < eSlotCount ; slot++ )                                               // marked again by RecalcVars() : the date, the editor position
+    {
+        if ( m_SlotLazy[slot] )
+            edited = true;
+    }
+
+    if ( ( stamp == m_MacrosStamp ) && ! edited )
+        return m_Macros;
+
+    ++m_Counters.macrosMerges;
+    m_Macros.clear();
+    for ( int layer = 0 ; layer < eLayerCount ; layer++ )                                           // lowest precedence first
+    {
+        MacrosLayer const & l = m_Layers[layer];
+
+        m_MacrosOwnerGen[layer] = ( l.view && l.owner ) ? l.owner->GetGeneration() : 0;
+        if ( l.view )
+            ReadMacros(m_Macros, l.owner);
+        for ( int k = 0 ; k < s_BuiltinCount ; k++ )                                                // each alias of the slots
+        {
+            int slot = s_BuiltinNames[k].slot;
+
+            if ( ( SlotLayer(slot) == layer ) && m_SlotSet[slot] )
+                m_Macros[s_BuiltinNames[k].name] = SlotGet(slot);
+        }
+        for ( MacrosMap::const_iterator it = l.macros.begin() ; it != l.macros.end() ; ++it )
+            m_Macros[it->first] = it->second;
     }
 
+    m_MacrosStamp = stamp;
+    return m_Macros;
+}
+//  ................................................................................................    ERG-
+void MacrosManager::RecalcVars(const cbProject* project, EditorBase* editor, const ProjectBuildTarget* target)
+{
+    //  ............................................................................................    ERG+
+    //  Each layer is rebuilt only if what it is built from changed : its owner ( project, target,
+    //  compiler ) or the owner's generation, the editor's file. The editor position and selection,
+    //  the standard paths and the dates are lazy slots : they are only marked here, and computed
+    //  by their first reference ( SlotFetch() ).
+    const wxString  prevEditorFilename  =   m_ActiveEditorFilename;
+    const Compiler* compiler            =   target ? CompilerFactory::GetCompiler(target->GetCompilerID()) : nullptr;
+    //  ............................................................................................    ERG-
+    m_ActiveEditorFilename = wxEmptyString; // invalidate
+    m_ActiveEditorLine     = -1;            // invalidate
+    m_ActiveEditorColumn   = -1;            // invalidate
+
+    //  ............................................................................................    ERG+
+    //  ERG the target vars are not erased from a common map anymore : eLayerTargetVars is simply
+    //  ERG reread when the target or its generation changes.
+    //  ............................................................................................    ERG-
+
     if (editor)
     {
       // don't use pointer to editor here, because this might be the same,
@@ -260,54 +961,52 @@ void MacrosManager::RecalcVars(const cbProject* project, EditorBase* editor, con
       if (editor->GetFilename() != m_ActiveEditorFilename)
           m_ActiveEditorFilename = editor->GetFilename();
 
-      // (re-) compute column and line but only in case it's a builtin-editor
-      if (editor->IsBuiltinEditor())
-      {
-          cbEditor*         cbEd  = static_cast<cbEditor*>(editor);
-          cbStyledTextCtrl* cbSTC = cbEd->GetControl();
-          if (cbSTC)
-          {
-              m_ActiveEditorLine = cbSTC->GetCurrentLine() + 1;
-              int pos = cbSTC->GetCurrentPos();
-              if (pos!=-1)
-                  m_ActiveEditorColumn = cbSTC->GetColumn(pos) + 1;
-          }
-      }
+      //  ..........................................................................................    ERG+
+      //  ERG the line and column are read by SlotFetch(), when referenced
+      //  ERG // (re-) compute column and line but only in case it's a builtin-editor
+      //  ERG if (editor->IsBuiltinEditor())
+      //  ERG {
+      //  ERG     cbEditor*         cbEd  = static_cast<cbEditor*>(editor);
+      //  ERG     cbStyledTextCtrl* cbSTC = cbEd->GetControl();
+      //  ERG     if (cbSTC)
+      //  ERG     {
+      //  ERG         m_ActiveEditorLine = cbSTC->GetCurrentLine() + 1;
+      //  ERG         int pos = cbSTC->GetCurrentPos();
+      //  ERG         if (pos!=-1)
+      //  ERG             m_ActiveEditorColumn = cbSTC->GetColumn(pos) + 1;
+      //  ERG     }
+      //  ERG }
+      //  ..........................................................................................    ERG-
     }
 
+    //  ............................................................................................    ERG+
     if (!project)
     {
-        m_ProjectFilename = wxEmptyString;
-        m_ProjectName     = wxEmptyString;
-        m_ProjectDir      = wxEmptyString;
-        m_ProjectFiles    = wxEmptyString;
-        m_Makefile        = wxEmptyString;
-        m_LastProject     = nullptr;
-        ClearProjectKeys();
-        m_Macros[_T("PROJECTFILE")]          = wxEmptyString;
-        m_Macros[_T("PROJECT_FILE")]         = wxEmptyString;
-        m_Macros[_T("PROJECTFILENAME")]      = wxEmptyString;
-        m_Macros[_T("PROJECT_FILENAME")]     = wxEmptyString;
-        m_Macros[_T("PROJECT_FILE_NAME")]    = wxEmptyString;
-        m_Macros[_T("PROJECTNAME")]          = wxEmptyString;
-        m_Macros[_T("PROJECT_NAME")]         = wxEmptyString;
-        m_Macros[_T("PROJECTDIR")]           = wxEmptyString;
-        m_Macros[_T("PROJECT_DIR")]          = wxEmptyString;
-        m_Macros[_T("PROJECTDIRECTORY")]     = wxEmptyString;
-        m_Macros[_T("PROJECT_DIRECTORY")]    = wxEmptyString;
-        m_Macros[_T("PROJECTTOPDIR")]        = wxEmptyString;
-        m_Macros[_T("PROJECT_TOPDIR")]       = wxEmptyString;
-        m_Macros[_T("PROJECTTOPDIRECTORY")]  = wxEmptyString;
-        m_Macros[_T("PROJECT_TOPDIRECTORY")] = wxEmptyString;
-        m_Macros[_T("MAKEFILE")]             = wxEmptyString;
-        m_Macros[_T("ALL_PROJECT_FILES")]    = wxEmptyString;
+        if ( ! LayerIsUpToDate(eLayerProject, nullptr, 0) )
+        {
+            m_ProjectFilename = wxEmptyString;
+            m_ProjectName     = wxEmptyString;
+            m_ProjectDir      = wxEmptyString;
+            m_ProjectPath     = wxEmptyString;
+            m_ProjectFiles    = wxEmptyString;
+            m_Makefile        = wxEmptyString;
+            m_LastProject     = nullptr;
+            ClearProjectKeys();
+
+            LayerRebuild(eLayerProject);
+            for ( int slot = eSlotProjectFile ; slot <= eSlotAllProjectFiles ; slot++ )
+                SlotSet(slot, wxEmptyString);
+        }
     }
     else if ( (project != m_LastProject) || (project->GetTitle() != m_ProjectName)
-                || (UnixFilename(project->GetBasePath()) != m_ProjectDir)
-                || (UnixFilename(m_ProjectWxFileName.GetFullName()) != m_ProjectFilename)
+                || ! LayerIsUpToDate(eLayerProject, project, project->GetOptionsGeneration())
+                //  ERG || (UnixFilename(project->GetBasePath()) != m_ProjectDir)
+                //  ERG || (UnixFilename(m_ProjectWxFileName.GetFullName()) != m_ProjectFilename)
+                || (project->GetFilename() != m_ProjectPath)                                        // both derive from it : no wxFileName built
              )
     {
         m_LastTarget      = nullptr; // reset last target when project changes
+        m_ProjectPath     = project->GetFilename();
         m_ProjectWxFileName.Assign(project->GetFilename());
         m_ProjectFilename = UnixFilename(m_ProjectWxFileName.GetFullName());
         m_ProjectName     = project->GetTitle();
@@ -324,23 +1023,14 @@ void MacrosManager::RecalcVars(const cbProject* project, EditorBase* editor, con
         }
 
         ClearProjectKeys();
-        m_Macros[_T("PROJECTFILE")]          = m_ProjectFilename;
-        m_Macros[_T("PROJECT_FILE")]         = m_ProjectFilename;
-        m_Macros[_T("PROJECTFILENAME")]      = m_ProjectFilename;
-        m_Macros[_T("PROJECT_FILENAME")]     = m_ProjectFilename;
-        m_Macros[_T("PROJECT_FILE_NAME")]    = m_ProjectFilename;
-        m_Macros[_T("PROJECTNAME")]          = m_ProjectName;
-        m_Macros[_T("PROJECT_NAME")]         = m_ProjectName;
-        m_Macros[_T("PROJECTDIR")]           = m_ProjectDir;
-        m_Macros[_T("PROJECT_DIR")]          = m_ProjectDir;
-        m_Macros[_T("PROJECTDIRECTORY")]     = m_ProjectDir;
-        m_Macros[_T("PROJECT_DIRECTORY")]    = m_ProjectDir;
-        m_Macros[_T("PROJECTTOPDIR")]        = m_ProjectTopDir;
-        m_Macros[_T("PROJECT_TOPDIR")]       = m_ProjectTopDir;
-        m_Macros[_T("PROJECTTOPDIRECTORY")]  = m_ProjectTopDir;
-        m_Macros[_T("PROJECT_TOPDIRECTORY")] = m_ProjectTopDir;
-        m_Macros[_T("MAKEFILE")]             = m_Makefile;
-        m_Macros[_T("ALL_PROJECT_FILES")]    = m_ProjectFiles;
+
+        MacrosMap & macros = LayerRebuild(eLayerProject, project, project->GetOptionsGeneration());   // only the outputs of the targets
+        SlotSet(eSlotProjectFile    , m_ProjectFilename);
+        SlotSet(eSlotProjectName    , m_ProjectName);
+        SlotSet(eSlotProjectDir     , m_ProjectDir);
+        SlotSet(eSlotProjectTopDir  , m_ProjectTopDir);
+        SlotSet(eSlotMakefile       , m_Makefile);
+        SlotSet(eSlotAllProjectFiles, m_ProjectFiles);
 
         for (int i = 0; i < project->GetBuildTargetsCount(); ++i)
         {
@@ -352,353 +1042,2026 @@ void MacrosManager::RecalcVars(const cbProject* project, EditorBase* editor, con
                 ; // replace spaces with underscores (what about other invalid chars?)
 
             const wxString outputName = it_target->GetOutputFilename();
-            m_Macros[title + _T("_OUTPUT_FILE")]     = UnixFilename(outputName);
-            m_Macros[title + _T("_OUTPUT_DIR")]      = UnixFilename(it_target->GetBasePath());
-            m_Macros[title + _T("_OUTPUT_BASENAME")] = wxFileName(outputName).GetName();
-            m_Macros[title + _T("_PARAMETERS")]      = it_target->GetExecutionParameters();
+            macros[title + _T("_OUTPUT_FILE")]     = UnixFilename(outputName);
+            macros[title + _T("_OUTPUT_DIR")]      = UnixFilename(it_target->GetBasePath());
+            macros[title + _T("_OUTPUT_BASENAME")] = wxFileName(outputName).GetName();
+            macros[title + _T("_PARAMETERS")]      = it_target->GetExecutionParameters();
         }
         m_LastProject = project;
     }
 
-    // get compiler variables
-    if (target)
-    {
-        const Compiler* compiler = CompilerFactory::GetCompiler(target->GetCompilerID());
-        ReadMacros(m_Macros, compiler);
-    }
-
-    ReadMacros(m_Macros, project);
-
-    if (!target)
-    {
-        m_TargetOutputDir      = wxEmptyString;
-        m_TargetName           = wxEmptyString;
-        m_TargetOutputBaseName = wxEmptyString;
-        m_TargetOutputFilename = wxEmptyString;
-        m_TargetFilename       = wxEmptyString;
-        m_LastTarget           = nullptr;
-    }
-    else if ( (target != m_LastTarget) or (target->GetTitle() != m_TargetName) )
-    {
-        const wxString outputName = target->GetOutputFilename();
-        const wxFileName tod(outputName);
-        m_TargetOutputDir      = UnixFilename(tod.GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR));
-        m_TargetName           = UnixFilename(target->GetTitle());
-        m_TargetOutputBaseName = tod.GetName();
-        m_TargetOutputFilename = tod.GetFullName();
-        m_TargetFilename       = UnixFilename(outputName);
-        m_LastTarget           = target;
-    }
-
+    // get compiler variables ( the compiler layer is kept as is when there is no target )
     if (target)
-    {
-        ReadMacros(m_Macros, target);
-
-        if (Compiler* c = CompilerFactory::GetCompiler(target->GetCompilerID()))
-        {
-            m_Macros[_T("TARGET_CC")]           = c->GetPrograms().C;
-            m_Macros[_T("TARGET_CPP")]          = c->GetPrograms().CPP;
-            m_Macros[_T("TARGET_LD")]           = c->GetPrograms().LD;
-            m_Macros[_T("TARGET_LIB")]          = c->GetPrograms().LIB;
-            wxFileName MasterPath;
-            MasterPath.SetPath(c->GetMasterPath(), wxPATH_NATIVE);
-            m_Macros[_T("TARGET_COMPILER_DIR")] = MasterPath.GetPathWithSep(wxPATH_NATIVE);
-        }
-        m_Macros[_T("TARGET_OBJECT_DIR")] = target->GetObjectOutput();
-    }
-
-    m_Macros[_T("TARGET_OUTPUT_DIR")]      = m_TargetOutputDir;
-    m_Macros[_T("TARGET_NAME")]            = m_TargetName;
-    m_Macros[_T("TARGET_OUTPUT_BASENAME")] = m_TargetOutputBaseName;
-    m_Macros[_T("TARGET_OUTPUT_FILENAME")] = m_TargetOutputFilename;
-    m_Macros[_T("TARGET_OUTPUT_FILE")]     = m_TargetFilename;
-
-    m_Macros[_T("ACTIVE_EDITOR_FILENAME")] = UnixFilename(m_ActiveEditorFilename);
-    wxFileName fn(m_Macros[_T("ACTIVE_EDITOR_FILENAME")]);
-    m_Macros[_T("ACTIVE_EDITOR_DIRNAME")]  = fn.GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR);
-    m_Macros[_T("ACTIVE_EDITOR_STEM")]     = fn.GetName();
-    m_Macros[_T("ACTIVE_EDITOR_EXT")]      = fn.GetExt();
-
-    wxString temp_str;
-    temp_str.Printf(_T("%d"), m_ActiveEditorLine);
-    m_Macros[_T("ACTIVE_EDITOR_LINE")]     = temp_str;
-    temp_str.Printf(_T("%d"), (m_ActiveEditorLine>0) ? m_ActiveEditorLine-1 : -1); // zero based, but keep value for "invalid"
-    m_Macros[_T("ACTIVE_EDITOR_LINE_0")]   = temp_str;
-    temp_str.Printf(_T("%d"), m_ActiveEditorColumn);
-    m_Macros[_T("ACTIVE_EDITOR_COLUMN")]   = temp_str;
-    temp_str.Printf(_T("%d"), (m_ActiveEditorColumn>0) ? m_ActiveEditorColumn-1 : -1); // zero based, but keep value for "invalid"
-    m_Macros[_T("ACTIVE_EDITOR_COLUMN_0")] = temp_str;
-    m_Macros[_T("ACTIVE_EDITOR_SELECTION")] = GetSelectedText();
-
-    // Wrapper for WX standard path's methods:
-
-    // Unix: prefix/share/appname   Windows: EXE path
-    m_Macros[_T("GET_DATA_DIR")]            = ((const wxStandardPaths&)wxStandardPaths::Get()).GetDataDir();
-    // Unix: /etc/appname   Windows: EXE path
-    m_Macros[_T("GET_LOCAL_DATA_DIR")]      = ((const wxStandardPaths&)wxStandardPaths::Get()).GetLocalDataDir();
-    // Unix: ~   Windows: C:\Documents and Settings\username\Documents
-    m_Macros[_T("GET_DOCUMENTS_DIR")]       = ((const wxStandardPaths&)wxStandardPaths::Get()).GetDocumentsDir();
-    // Unix: /etc   Windows: C:\Documents and Settings\All Users\Application Data
-    m_Macros[_T("GET_CONFIG_DIR")]          = ((const wxStandardPaths&)wxStandardPaths::Get()).GetConfigDir();
-    // Unix: ~   Windows: C:\Documents and Settings\username\Application Data\appname
-    m_Macros[_T("GET_USER_CONFIG_DIR")]     = ((const wxStandardPaths&)wxStandardPaths::Get()).GetUserConfigDir();
-    // Unix: ~/.appname   Windows: C:\Documents and Settings\username\Application Data
-    m_Macros[_T("GET_USER_DATA_DIR")]       = ((const wxStandardPaths&)wxStandardPaths::Get()).GetUserDataDir();
-    // Unix: ~/.appname   Windows: C:\Documents and Settings\username\Local Settings\Application Data\appname
-    m_Macros[_T("GET_USER_LOCAL_DATA_DIR")] = ((const wxStandardPaths&)wxStandardPaths::Get()).GetUserLocalDataDir();
-    // ALl platforms: A writable, temporary directory
-    m_Macros[_T("GET_TEMP_DIR")]            = ((const wxStandardPaths&)wxStandardPaths::Get()).GetTempDir();
-
-    wxDateTime now(wxDateTime::Now());
-    m_Macros[_T("TDAY")]        = now.Format(_T("%Y%m%d"));
-    m_Macros[_T("TODAY")]       = now.Format(_T("%Y-%m-%d"));
-    m_Macros[_T("NOW")]         = now.Format(_T("%Y-%m-%d-%H.%M"));
-    m_Macros[_T("NOW_L")]       = now.Format(_T("%Y-%m-%d-%H.%M.%S"));
-    m_Macros[_T("WEEKDAY")]     = now.Format(_T("%A"));
-
-    wxDateTime nowGMT(now.ToGMT());
-    m_Macros[_T("TDAY_UTC")]    = nowGMT.Format(_T("%Y%m%d"));
-    m_Macros[_T("TODAY_UTC")]   = nowGMT.Format(_T("%Y-%m-%d"));
-    m_Macros[_T("NOW_UTC")]     = nowGMT.Format(_T("%Y-%m-%d-%H.%M"));
-    m_Macros[_T("NOW_L_UTC")]   = nowGMT.Format(_T("%Y-%m-%d-%H.%M.%S"));
-    m_Macros[_T("WEEKDAY_UTC")] = nowGMT.Format(_T("%A"));
-
-    wxDateTime january_1_2010(1, wxDateTime::Jan, 2010, 0, 0, 0, 0);
-    wxTimeSpan ts = now.Subtract(january_1_2010);
-    m_Macros[_T("DAYCOUNT")] = wxString::Format(_T("%d"), ts.GetDays());
-}
-
-void MacrosManager::ReplaceMacros(wxString& buffer, const ProjectBuildTarget* target, bool subrequest)
-{
-    if (buffer.IsEmpty())
-        return;
+        LayerBindVars(eLayerCompilerVars, compiler);
 
-    static const wxString delim(_T("$%["));
-    if ( buffer.find_first_of(delim) == wxString::npos )
-        return;
-
-    const cbProject* project = target
-                             ? target->GetParentProject()
-                             : Manager::Get()->GetProjectManager()->GetActiveProject();
-    EditorBase* editor = Manager::Get()->GetEditorManager()->GetActiveEditor();
+    LayerBindVars(eLayerProjectVars, project);
+    LayerBindVars(eLayerTargetVars , target );
 
-    if (!target)
+    const unsigned long targetGen = target ? target->GetOptionsGeneration() + ( compiler ? compiler->GetOptionsGeneration() : 0 ) : 0;
+    if ( ! LayerIsUpToDate(eLayerTarget, target, targetGen) )
     {
-        if (project)
+        if (!target)
         {
-            // use the currently compiling target
-            target = project->GetCurrentlyCompilingTarget();
-            // if none,
-            if (!target)
-                // use the last known active target
-                target = project->GetBuildTarget(project->GetActiveBuildTarget());
+            m_TargetOutputDir      = wxEmptyString;
+            m_TargetName           = wxEmptyString;
+            m_TargetOutputBaseName = wxEmptyString;
+            m_TargetOutputFilename = wxEmptyString;
+            m_TargetFilename       = wxEmptyString;
+        }
+        else
+        {
+            const wxString outputName = target->GetOutputFilename();
+            const wxFileName tod(outputName);
+            m_TargetOutputDir      = UnixFilename(tod.GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR));
+            m_TargetName           = UnixFilename(target->GetTitle());
+            m_TargetOutputBaseName = tod.GetName();
+            m_TargetOutputFilename = tod.GetFullName();
+            m_TargetFilename       = UnixFilename(outputName);
         }
-    }
-    if (project != m_LastProject || target != m_LastTarget || (editor && (editor->GetFilename() != m_ActiveEditorFilename))
-                    || (project && (UnixFilename(project->GetBasePath()) != m_ProjectDir))
-                    || (UnixFilename(m_ProjectWxFileName.GetFullName()) != m_ProjectFilename)
-                    || (target && (target->GetTitle() != m_TargetName)) )
-        RecalcVars(project, editor, target);
 
-    wxString search;
-    wxString replace;
+        LayerRebuild(eLayerTarget, target, targetGen);
 
-    if (buffer.find(_T("$if")) != wxString::npos)
-    {
-        while (m_RE_If.Matches(buffer))
+        if (target)
         {
-            search = m_RE_If.GetMatch(buffer, 0);
-            replace = EvalCondition(m_RE_If.GetMatch(buffer, 1), m_RE_If.GetMatch(buffer, 3), m_RE_If.GetMatch(buffer, 5), target);
-            buffer.Replace(search, replace, false);
+            if (compiler)
+            {
+                SlotSet(eSlotTargetCC , compiler->GetPrograms().C);
+                SlotSet(eSlotTargetCPP, compiler->GetPrograms().CPP);
+                SlotSet(eSlotTargetLD , compiler->GetPrograms().LD);
+                SlotSet(eSlotTargetLIB, compiler->GetPrograms().LIB);
+                wxFileName MasterPath;
+                MasterPath.SetPath(compiler->GetMasterPath(), wxPATH_NATIVE);
+                SlotSet(eSlotTargetCompilerDir, MasterPath.GetPathWithSep(wxPATH_NATIVE));
+            }
+            SlotSet(eSlotTargetObjectDir, target->GetObjectOutput());
         }
-    }
 
-    while (m_RE_Script.Matches(buffer))
-    {
-        search = m_RE_Script.GetMatch(buffer, 1);
-        replace = Manager::Get()->GetScriptingManager()->LoadBufferRedirectOutput(m_RE_Script.GetMatch(buffer, 2));
-        buffer.Replace(search, replace, false);
-    }
-
-    while (m_RE_ToAbsolutePath.Matches(buffer))
-    {
-        search = m_RE_ToAbsolutePath.GetMatch(buffer, 0);
-        const wxString relativePath = m_RE_ToAbsolutePath.GetMatch(buffer, 1);
-        wxFileName fn(relativePath);
-        fn.MakeAbsolute();
-        replace = fn.GetFullPath();
-        buffer.Replace(search, replace, false);
+        SlotSet(eSlotTargetOutputDir , m_TargetOutputDir);
+        SlotSet(eSlotTargetName      , m_TargetName);
+        SlotSet(eSlotTargetOutputBase, m_TargetOutputBaseName);
+        SlotSet(eSlotTargetOutputName, m_TargetOutputFilename);
+        SlotSet(eSlotTargetOutputFile, m_TargetFilename);
     }
+    m_LastTarget = target;
 
-    while (m_RE_To83Path.Matches(buffer))
+    if ( ! m_Layers[eLayerEditor].valid || ( m_ActiveEditorFilename != prevEditorFilename ) )
     {
-        search = m_RE_To83Path.GetMatch(buffer, 0);
-        const wxString path = m_RE_To83Path.GetMatch(buffer, 1);
-        wxFileName fn(path);
-        fn.MakeAbsolute(); // make absolute before translating to 8.3 notation
-        replace = fn.GetShortPath();
-        buffer.Replace(search, replace, false);
+        LayerRebuild(eLayerEditor);
+        SlotSet(eSlotEditorFilename, UnixFilename(m_ActiveEditorFilename));
+        wxFileName fn(m_Slots[eSlotEditorFilename]);
+        SlotSet(eSlotEditorDirname , fn.GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR));
+        SlotSet(eSlotEditorStem    , fn.GetName());
+        SlotSet(eSlotEditorExt     , fn.GetExt());
     }
+    SlotLazy(eSlotEditorLine, eSlotEditorSelection);                                                // read again after each RecalcVars()
 
-    int index = wxNOT_FOUND;
-    while ((index = buffer.Index(toNativePath.wx_str())) != wxNOT_FOUND)
+    if ( ! m_Layers[eLayerStdPaths].valid )                                                         // they do not change while C::B runs
     {
-        int end = MatchBrace(buffer, index + toNativePath.Length() - 1);
-        wxString content = buffer.Mid(index + toNativePath.Length(), end - index - toNativePath.Length());
-        ReplaceMacros(content, target, true);
-        buffer.Replace(buffer.Mid(index, end - index + 1), UnixFilename(content), false);
+        LayerRebuild(eLayerStdPaths);
+        SlotLazy(eSlotDataDir, eSlotTempDir);
     }
 
-    while ((index = buffer.Index(toUnixPath.wx_str())) != wxNOT_FOUND)
-    {
-        int end = MatchBrace(buffer, index + toUnixPath.Length() - 1);
-        wxString content = buffer.Mid(index + toUnixPath.Length(), end - index - toUnixPath.Length());
-        ReplaceMacros(content, target, true);
-        buffer.Replace(buffer.Mid(index, end - index + 1), UnixFilename(content, wxPATH_UNIX), false);
-    }
+    if ( ! m_Layers[eLayerTime].valid )
+        LayerRebuild(eLayerTime);
+    SlotLazy(eSlotTday, eSlotDaycount);                                                             // the date of the first reference after RecalcVars()
+    //  ............................................................................................    ERG-
+}
 
-    while ((index = buffer.Index(toWindowsPath.wx_str())) != wxNOT_FOUND)
-    {
-        int end = MatchBrace(buffer, index + toWindowsPath.Length() - 1);
-        wxString content = buffer.Mid(index + toWindowsPath.Length(), end - index - toWindowsPath.Length());
-        ReplaceMacros(content, target, true);
-        buffer.Replace(buffer.Mid(index, end - index + 1), UnixFilename(content, wxPATH_WIN), false);
-    }
+//  ................................................................................................    ERG+
+//  MacroTemplate compiler
+//  ................................................................................................
+namespace
+{
+inline bool IsMacroNameChar(wxChar c)
+{
+    return ( ( c >= _T('A') ) && ( c <= _T('Z') ) ) || ( ( c >= _T('a') ) && ( c <= _T('z') ) )
+        || ( ( c >= _T('0') ) && ( c <= _T('9') ) ) || ( c == _T('_') ) || ( c == _T('.') );
+}
 
-    while (m_RE_RemoveQuotes.Matches(buffer))
-    {
-        search = m_RE_RemoveQuotes.GetMatch(buffer, 0);
-        wxString content = m_RE_RemoveQuotes.GetMatch(buffer, 1).Trim().Trim(false);
-        if (content.StartsWith(wxT("$")))
-            ReplaceMacros(content, target, subrequest);
-        if (content.Len()>2 && content.StartsWith(wxT("\"")) && content.EndsWith(wxT("\"")))
-        {
-            replace = content.Mid(1,content.Len()-2); // with first and last char (the quotes) removed
-            buffer.Replace(search, replace, false);
-        }
-        else
-            buffer.Replace(search, content, false);
-    }
+/// [::space::] of the former $if regex is not a class, but the set of the chars of ":space:".
+inline bool IsIfSpaceChar(wxChar c)
+{
+    return ( c == _T(':') ) || ( c == _T('s') ) || ( c == _T('p') ) || ( c == _T('a') ) || ( c == _T('c') ) || ( c == _T('e') );
+}
 
-    while (m_RE_Unix.Matches(buffer))
-    {
-        replace.Empty();
-        search = m_RE_Unix.GetMatch(buffer, 2);
+inline bool IsDelimiter(wxChar c)
+{
+    return ( c == _T('$') ) || ( c == _T('%') ) || ( c == _T('[') );
+}
 
-        wxString var = m_RE_Unix.GetMatch(buffer, 3).Upper();
+#ifdef MACROS_SCAN_WIDTH
+/// Bit k set if byte k of the MACROS_SCAN_WIDTH bytes at _i_p is '$', '%' or '['.
+inline unsigned ScanBlock(char const * _i_p)
+{
+#if MACROS_SCAN_WIDTH == 32
+    const __m256i   v   =   _mm256_loadu_si256( reinterpret_cast< __m256i const * >(_i_p) );
+    const __m256i   m   =   _mm256_or_si256( _mm256_or_si256(   _mm256_cmpeq_epi8(v, _mm256_set1_epi8('$')),
+                                                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('%')) ),
+                                                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('[')) );
+    return static_cast< unsigned >( _mm256_movemask_epi8(m) );
+#else
+    const __m128i   v   =   _mm_loadu_si128( reinterpret_cast< __m128i const * >(_i_p) );
+    const __m128i   m   =   _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8(v, _mm_set1_epi8('$')),
+                                                        _mm_cmpeq_epi8(v, _mm_set1_epi8('%')) ),
+                                                        _mm_cmpeq_epi8(v, _mm_set1_epi8('[')) );
+    return static_cast< unsigned >( _mm_movemask_epi8(m) );
+#endif
+}
 
-        if (var.GetChar(0) == _T('#'))
-            replace = UnixFilename(m_UserVarMan->Replace(var));
-        else
-        {
-            if (var.compare(const_COIN) == 0)
-                replace.assign(1u, rand() & 1 ? _T('1') : _T('0'));
-            else if (var.compare(const_RANDOM) == 0)
-                replace = wxString::Format(_T("%d"), rand() & 0xffff);
-            else
-            {
-                MacrosMap::iterator it;
-                if ((it = m_Macros.find(var)) != m_Macros.end())
-                    replace = it->second;
-            }
-        }
+inline unsigned LowestBit(unsigned _i_mask)
+{
+#ifdef _MSC_VER
+    unsigned long k;
+    _BitScanForward(&k, _i_mask);
+    return static_cast< unsigned >( k );
+#else
+    return static_cast< unsigned >( __builtin_ctz(_i_mask) );
+#endif
+}
+#endif
 
-        const wxChar l = search.Last(); // make non-braced variables work
-        if (l == _T('/') || l == _T('\\') || l == _T('$') || l == _T(' '))
-            replace.append(l);
+/** Index of the first '$', '%' or '[' of [_i_pos, _i_end), or _i_end. Most of a command line
+  * is literal : with SSE2 / AVX2 the wchar_t are compared by their bytes, a block at a time.
+  * Only the low byte of each char is kept ( x86 is little endian ), and a match is checked on
+  * the whole char, since e.g. U+0124 has the low byte of '$'.
+  */
+size_t FindDelimiter(wxString const & _i_src, size_t _i_pos, size_t _i_end)
+{
+#ifdef MACROS_SCAN_WIDTH
+    wchar_t const   *   s       =   _i_src.wx_str();
+    const unsigned      low     =   ( sizeof(wchar_t) == 4 ) ? 0x11111111u : 0x55555555u;          // byte 0 of each char
+    const size_t        step    =   MACROS_SCAN_WIDTH / sizeof(wchar_t);
+    //  ............................................................................................
+    for ( ; _i_pos + step <= _i_end ; _i_pos += step )
+    {
+        unsigned mask = ScanBlock( reinterpret_cast< char const * >(s + _i_pos) ) & low;
 
-        if (replace.IsEmpty())
-            wxGetEnv(var, &replace);
+        for ( ; mask ; mask &= mask - 1 )
+        {
+            size_t k = _i_pos + LowestBit(mask) / sizeof(wchar_t);
 
-        buffer.Replace(search, replace, false);
+            if ( IsDelimiter(s[k]) )
+                return k;
+        }
     }
+#endif
+    for ( ; _i_pos < _i_end ; _i_pos++ )
+        if ( IsDelimiter(_i_src[_i_pos]) )
+            break;
 
-    while (m_RE_DOS.Matches(buffer))
+    return _i_pos;
+}
+
+inline bool StartsAt(wxString const & _i_src, size_t _i_pos, size_t _i_end, wxString const & _i_what)
+{
+    return ( _i_pos + _i_what.length() <= _i_end ) && ( _i_src.compare(_i_pos, _i_what.length(), _i_what) == 0 );
+}
+
+inline bool Holds(wxString const & _i_src, size_t _i_begin, size_t _i_end, wxChar _i_c)
+{
+    for ( size_t i = _i_begin ; i < _i_end ; i++ )
+        if ( _i_src[i] == _i_c )
+            return true;
+
+    return false;
+}
+
+/** Index of the first c in [pos, end), not crossing a newline if line ; end if none. A scan is
+  * reused while the next start lies inside it : the starts only grow along a range, and without
+  * that each "$if(" or "$TO_83_PATH{" missing its end would rescan the rest of the line, making
+  * a long command line quadratic.
+  */
+class CharFinder
+{
+    public:
+        CharFinder(wxString const & _i_src, size_t _i_end, wxChar _i_c, bool _i_line)
+            :   m_Src(_i_src), m_End(_i_end), m_C(_i_c), m_Line(_i_line), m_From(1), m_Stop(0), m_Result(_i_end)  {   }
+
+        size_t  Find(size_t _i_pos)
+        {
+            if ( ( _i_pos < m_From ) || ( _i_pos > m_Stop ) )                                       // outside the last scan
+            {
+                for ( m_From = m_Stop = _i_pos ; m_Stop < m_End ; m_Stop++ )
+                    if ( ( m_Src[m_Stop] == m_C ) || ( m_Line && ( m_Src[m_Stop] == _T('\n') ) ) )
+                        break;
+
+                m_Result = ( ( m_Stop < m_End ) && ( m_Src[m_Stop] == m_C ) ) ? m_Stop : m_End;
+            }
+            return m_Result;
+        }
+
+    private:
+        wxString    const   &   m_Src;
+        size_t                  m_End;
+        wxChar                  m_C;
+        bool                    m_Line;
+        size_t                  m_From;                                                             //!< last scan : [m_From, m_Stop]
+        size_t                  m_Stop;                                                             //!< the char, a newline, or m_End
+        size_t                  m_Result;
+};
+
+/// Name of $VAR / %VAR% at _i_pos : #?[A-Za-z_0-9.]+ ; returns its end, or _i_pos if none.
+size_t MatchMacroName(wxString const & _i_src, size_t _i_pos, size_t _i_end)
+{
+    size_t  p   =   _i_pos;
+    size_t  q;
+    //  ............................................................................................
+    if ( ( p < _i_end ) && ( _i_src[p] == _T('#') ) )
+        ++p;
+
+    for ( q = p ; ( q < _i_end ) && IsMacroNameChar(_i_src[q]) ; q++ ) {}
+
+    return ( q == p ) ? _i_pos : q;
+}
+
+/** Closing bracket of each '(' and '{' of [_i_begin, _i_end), on the same line if _i_line.
+  * The table is built by the first Match(), in one pass with a stack per kind : a range
+  * without $if / $TO_*_PATH{ does not pay for it, and nested or unterminated constructs do
+  * not rescan the range. Without _i_line, the '}' found are the ones of MatchBrace().
+  */
+class BracketMatcher
+{
+    public:
+        BracketMatcher(wxString const & _i_src, size_t _i_begin, size_t _i_end, bool _i_line)
+            :   m_Src(_i_src), m_Begin(_i_begin), m_End(_i_end), m_Line(_i_line), m_Built(false)  {   }
+
+        /// Index of the bracket closing the one at _i_open, or the end of the range.
+        size_t  Match(size_t _i_open)
+        {
+            if ( ! m_Built )
+                Build();
+            return m_Match[_i_open - m_Begin];
+        }
+
+    private:
+        void    Build()
+        {
+            std::vector< size_t >   parens;
+            std::vector< size_t >   braces;
+            //  ....................................................................................
+            m_Match.assign(m_End - m_Begin, m_End);
+            for ( size_t p = m_Begin ; p < m_End ; p++ )
+            {
+                switch ( m_Src[p] )
+                {
+                    case _T('\n')   :
+                        if ( m_Line )
+                        {
+                            parens.clear();
+                            braces.clear();
+                        }
+                        break;
+                    case _T('(')    :   parens.push_back(p);                                            break;
+                    case _T('{')    :   braces.push_back(p);                                            break;
+                    case _T(')')    :
+                        if ( ! parens.empty() )
+                        {
+                            m_Match[parens.back() - m_Begin] = p;
+                            parens.pop_back();
+                        }
+                        break;
+                    case _T('}')    :
+                        if ( ! braces.empty() )
+                        {
+                            m_Match[braces.back() - m_Begin] = p;
+                            braces.pop_back();
+                        }
+                        break;
+                    default         :                                                                   break;
+                }
+            }
+            m_Built = true;
+        }
+
+        wxString    const   &   m_Src;
+        size_t                  m_Begin;
+        size_t                  m_End;
+        bool                    m_Line;
+        bool                    m_Built;
+        std::vector< size_t >   m_Match;                                                            //!< by offset from m_Begin ; m_End if not a matched opening bracket
+};
+
+/// Operator of a $if condition ( MacroNode::cond ).
+enum
+{
+    eIfNever    ,                                                                                   // nothing but =!<> : the former regex did not match ; a $if comparison that does not hold
+    eIfAlways   ,                                                                                   // a $if comparison that holds
+    eIfTrue     ,                                                                                   // no operator : not empty, "0" nor "false" ( $ifnum : a number, not 0 )
+    eIfEq       ,                                                                                   // = ==
+    eIfNe       ,                                                                                   // !=
+    eIfLt       ,                                                                                   // <
+    eIfGt       ,                                                                                   // >
+    eIfLe       ,                                                                                   // <=
+    eIfGe                                                                                           // >=
+};
+
+struct IfCondition
+{
+    int     op;
+    size_t  leftBegin;                                                                              // eIfTrue : the whole condition
+    size_t  leftEnd;
+    size_t  rightBegin;
+    size_t  rightEnd;
+};
+
+inline bool IsIfOperatorChar(wxChar c)
+{
+    return ( c == _T('=') ) || ( c == _T('!') ) || ( c == _T('<') ) || ( c == _T('>') );
+}
+
+/// End of the operand starting at _i_pos : the first =!<> outside the nested brackets, or _i_end.
+size_t IfOperandEnd(wxString const & _i_src, size_t _i_pos, size_t _i_end)
+{
+    int depth = 0;
+    //  ............................................................................................
+    for ( ; _i_pos < _i_end ; _i_pos++ )
+    {
+        wxChar c = _i_src[_i_pos];
+
+        if      ( ( c == _T('(') ) || ( c == _T('{') ) || ( c == _T('[') ) )
+        {
+            ++depth;
+        }
+        else if ( ( c == _T(')') ) || ( c == _T('}') ) || ( c == _T(']') ) )
+        {
+            if ( depth )
+                --depth;
+        }
+        else if ( ( depth == 0 ) && IsIfOperatorChar(c) )
+        {
+            break;
+        }
+    }
+
+    return _i_pos;
+}
+
+/** Parse the raw condition [_i_begin, _i_end) once, as the former regex
+  * [^=!<>]+|(([^=!<>]+)[ ]*(=|==|!=|>|<|>=|<=)[ ]*([^=!<>]+)) matched it ( leftmost, then
+  * longest ) : the left operand is the first run of other chars, the operator follows it and
+  * must be followed by the right operand, the next run. What a nested construct encloses
+  * ( $(VAR), $if(...){...}, [[...]] ) is part of a run : its =!<> are not operators.
+  */
+IfCondition ParseCondition(wxString const & _i_src, size_t _i_begin, size_t _i_end)
+{
+    IfCondition     c       =   { eIfNever, _i_begin, _i_end, _i_end, _i_end };
+    size_t          p       =   _i_begin;
+    //  ............................................................................................
+    while ( ( p < _i_end ) && IsIfOperatorChar(_i_src[p]) )
+        ++p;
+    if ( p == _i_end )
+        return c;                                                                                   // eIfNever
+
+    c.op = eIfTrue;
+
+    size_t  le  =   IfOperandEnd(_i_src, p, _i_end);
+    size_t  o   =   le;
+    int     op  =   eIfTrue;
+
+    if ( ( o + 2 < _i_end ) && ( _i_src[o + 1] == _T('=') ) && ! IsIfOperatorChar(_i_src[o + 2]) )
+    {
+        switch ( _i_src[o] )
+        {
+            case _T('=')    :   op = eIfEq;     break;
+            case _T('!')    :   op = eIfNe;     break;
+            case _T('<')    :   op = eIfLe;     break;
+            case _T('>')    :   op = eIfGe;     break;
+        }
+        o += 2;
+    }
+    else if ( ( o + 1 < _i_end ) && ! IsIfOperatorChar(_i_src[o + 1]) )
+    {
+        switch ( _i_src[o] )
+        {
+            case _T('=')    :   op = eIfEq;     break;
+            case _T('<')    :   op = eIfLt;     break;
+            case _T('>')    :   op = eIfGt;     break;
+        }
+        o += 1;
+    }
+
+    if ( op != eIfTrue )
+    {
+        c.op            =   op;
+        c.leftBegin     =   p;
+        c.leftEnd       =   le;
+        c.rightBegin    =   o;
+        c.rightEnd      =   IfOperandEnd(_i_src, o, _i_end);
+    }
+
+    return c;
+}
+
+/// $ifnum operand : an integer, else a decimal number.
+bool ToNumber(wxString const & _i_value, double & _o_number)
+{
+    long l;
+    //  ............................................................................................
+    if ( _i_value.ToLong(&l) )
+    {
+        _o_number = static_cast< double >( l );
+        return true;
+    }
+    return _i_value.ToDouble(&_o_number);
+}
+
+/// Whether the condition holds, given its operands ; a $ifnum operand that is not a number makes it false.
+bool IfHolds(int _i_op, bool _i_numeric, wxString const & _i_left, wxString const & _i_right)
+{
+    int compare;
+    //  ............................................................................................
+    if ( _i_op == eIfNever )
+        return false;
+    if ( _i_op == eIfAlways )
+        return true;
+
+    if ( _i_op == eIfTrue )
+    {
+        double v;
+
+        if ( _i_numeric )
+            return ToNumber(_i_left.Strip(wxString::both), v) && ( v != 0 );
+
+        return ! ( _i_left.IsEmpty() || _i_left.IsSameAs(_T("0")) || _i_left.IsSameAs(_T("false")) );
+    }
+
+    wxString    left    (_i_left.Strip(wxString::both));
+    wxString    right   (_i_right.Strip(wxString::both));
+
+    if ( _i_numeric )
+    {
+        double l, r;
+
+        if ( ! ToNumber(left, l) || ! ToNumber(right, r) )
+            return false;
+        compare = ( l < r ) ? -1 : ( ( l > r ) ? 1 : 0 );
+    }
+    else
+        compare = left.Cmp(right);
+
+    switch ( _i_op )
+    {
+        case eIfEq  :   return compare == 0;
+        case eIfNe  :   return compare != 0;
+        case eIfLt  :   return compare <  0;
+        case eIfGt  :   return compare >  0;
+        case eIfLe  :   return compare <= 0;
+        default     :   return compare >= 0;
+    }
+}
+
+struct PendingRange                                                                                 // a sequence to compile once the current one is complete
+{
+    int     node;
+    int     slot;
+    size_t  begin;
+    size_t  end;
+    int     from;
+    int     to;
+};
+} // namespace
+
+void MacrosManager::CompileMacros(MacroTemplate & _o_tpl, wxString const & _i_source, int _i_from_phase)
+{
+    int first;
+    //  ............................................................................................
+    _o_tpl.source       =   _i_source;
+    _o_tpl.fromPhase    =   _i_from_phase;
+    _o_tpl.nodes.clear();
+    CompileRange(_o_tpl, 0, _i_source.length(), _i_from_phase, ePhaseCount, first, _o_tpl.count);
+}
+
+/** Compile [_i_begin, _i_end) of _io_tpl.source, matching only the constructs of the phases
+  * [_i_from_phase, _i_to_phase). The sequence is appended to _io_tpl.nodes, then the nested
+  * sequences ( clauses, contents ) are appended after it. Each construct is matched as its
+  * former regex did :
+  * $if  : \$if\(([^)]*)\)[::space::]*(\{([^}]*)\})(\{([^}]*)\})? , no newline inside ; but a
+  *        bracket closes the one it matches on the line, if any, so that the condition and
+  *        the clauses may hold nested constructs ( $if($(VAR)){$if(...){...}} ). The
+  *        condition is parsed by ParseCondition() ; a comparison compares the operands as
+  *        written, as the former code did, and is resolved here ; one holding a ')' is no
+  *        $if, as the regex did not match it. $ifnum( ... ) likewise, but its operands are
+  *        expanded, then compared as numbers.
+  * [[ ]]: \[\[(.*)\]\] , the last ]] of the line
+  * $TO_ABSOLUTE_PATH{ $TO_83_PATH{ $REMOVE_QUOTES{ : up to the first }
+  * $TO_NATIVE_PATH{ $TO_UNIX_PATH{ $TO_WINDOWS_PATH{ : up to the matching }, else to the end
+  * $VAR : ([^$]|^)\$[({]?(#?[A-Za-z_0-9.]+)[)} /\\]?
+  * %VAR%: ([^%]|^)%(#?[A-Za-z_0-9.]+)%
+  */
+void MacrosManager::CompileRange(MacroTemplate & _io_tpl, size_t _i_begin, size_t _i_end, int _i_from_phase, int _i_to_phase, int & _o_first, int & _o_count)
+{
+    wxString            const   &   src     =   _io_tpl.source;
+    std::vector< MacroNode >    &   nodes   =   _io_tpl.nodes;
+    std::vector< PendingRange >     pending;
+    size_t                          text    =   _i_begin;                                           // start of the current literal
+    size_t                          i       =   _i_begin;
+    MacroNode                       n;
+    PendingRange                    subs[4];                                                        // nested ranges of n
+    int                             nsubs;
+    CharFinder                      parenLine   (src, _i_end, _T(')'), true );
+    CharFinder                      braceLine   (src, _i_end, _T('}'), true );
+    CharFinder                      brace       (src, _i_end, _T('}'), false);
+    BracketMatcher                  brackets    (src, _i_begin, _i_end, true );
+    BracketMatcher                  bracesAll   (src, _i_begin, _i_end, false);
+    size_t                          scriptFrom  =   1;                                              // last line scanned for ]] : [scriptFrom, scriptStop]
+    size_t                          scriptStop  =   0;
+    size_t                          scriptLast  =   _i_end;                                         // its last ]]
+    //  ............................................................................................
+    #define PHASE_ON(PHASE)     ( ( (PHASE) >= _i_from_phase ) && ( (PHASE) < _i_to_phase ) )
+
+    _o_first = static_cast< int >( nodes.size() );
+
+    while ( ( i = FindDelimiter(src, i, _i_end) ) < _i_end )                                       // literals are skipped in bulk
+    {
+        wxChar  c       =   src[i];
+        bool    found   =   false;
+
+        n           =   MacroNode(ePhaseText, i, i);
+        n.afterNode =   ( i == text );
+        nsubs       =   0;
+
+        if ( c == _T('$') )
+        {
+            //  $if(cond){true}{false} $ifnum(cond){true}{false}
+            bool ifNum = PHASE_ON(ePhaseIf) && StartsAt(src, i, _i_end, toIfNum);
+
+            if ( ifNum || ( PHASE_ON(ePhaseIf) && StartsAt(src, i, _i_end, toIf) ) )
+            {
+                size_t  cb  =   i + ( ifNum ? toIfNum : toIf ).length();
+                size_t  ce  =   brackets.Match(cb - 1);
+
+                if ( ce >= _i_end )                                                                 // unbalanced : the first ')', as the regex
+                    ce = parenLine.Find(cb);
+
+                if ( ce < _i_end )
+                {
+                    size_t p = ce + 1;
+
+                    while ( ( p < _i_end ) && IsIfSpaceChar(src[p]) )
+                        ++p;
+
+                    if ( ( p < _i_end ) && ( src[p] == _T('{') ) )
+                    {
+                        size_t te = brackets.Match(p);
+
+                        if ( te >= _i_end )
+                            te = braceLine.Find(p + 1);
+
+                        IfCondition c = ParseCondition(src, cb, ce);
+
+                        //  A comparison holding a ')' ( $(VAR), ... ) did not match the former
+                        //  regex : $if is then a var, the rest is text and its vars are expanded.
+                        if ( ( c.op > eIfTrue ) && ! ifNum && Holds(src, cb, ce, _T(')')) )
+                            te = _i_end;
+
+                        if ( te < _i_end )
+                        {
+                            if ( ( c.op > eIfTrue ) && ! ifNum )                                    // the raw operands : known now
+                            {
+                                c.op = IfHolds( c.op, false,
+                                                src.Mid(c.leftBegin , c.leftEnd  - c.leftBegin ),
+                                                src.Mid(c.rightBegin, c.rightEnd - c.rightBegin) ) ? eIfAlways : eIfNever;
+                            }
+
+                            n.kind      =   ePhaseIf;
+                            n.argBegin  =   cb;
+                            n.argEnd    =   ce;
+                            n.end       =   te + 1;
+                            n.cond      =   c.op;
+                            n.numeric   =   ifNum;
+
+                            PendingRange pt = { 0, 0, p + 1, te, ePhaseIf, ePhaseCount };
+                            subs[nsubs++] = pt;
+
+                            if ( c.op >= eIfTrue )                                                  // the operands are expanded as the whole condition was
+                            {
+                                PendingRange pl = { 0, 2, c.leftBegin, c.leftEnd, ePhaseIf, ePhaseCount };
+                                subs[nsubs++] = pl;
+                            }
+                            if ( c.op > eIfTrue )
+                            {
+                                PendingRange pr = { 0, 3, c.rightBegin, c.rightEnd, ePhaseIf, ePhaseCount };
+                                subs[nsubs++] = pr;
+                            }
+
+                            if ( ( te + 1 < _i_end ) && ( src[te + 1] == _T('{') ) )
+                            {
+                                size_t fe = brackets.Match(te + 1);
+
+                                if ( fe >= _i_end )
+                                    fe = braceLine.Find(te + 2);
+
+                                if ( fe < _i_end )
+                                {
+                                    PendingRange pf = { 0, 1, te + 2, fe, ePhaseIf, ePhaseCount };
+                                    subs[nsubs++] = pf;
+                                    n.end = fe + 1;
+                                }
+                            }
+                            found = true;
+                        }
+                    }
+                }
+            }
+            //  $TO_ABSOLUTE_PATH{path} $TO_83_PATH{path} : the content is what the former phases left
+            if ( ! found )
+            {
+                wxString const  *   fn      =   nullptr;
+                int                 phase   =   ePhaseCount;
+
+                if      ( PHASE_ON(ePhaseAbsolutePath)  && StartsAt(src, i, _i_end, toAbsolutePath) )   { fn = &toAbsolutePath; phase = ePhaseAbsolutePath; }
+                else if ( PHASE_ON(ePhase83Path)        && StartsAt(src, i, _i_end, to83Path) )         { fn = &to83Path;       phase = ePhase83Path;       }
+                else if ( PHASE_ON(ePhaseRemoveQuotes)  && StartsAt(src, i, _i_end, toRemoveQuotes) )   { fn = &toRemoveQuotes; phase = ePhaseRemoveQuotes; }
+
+                if ( fn )
+                {
+                    size_t  cb  =   i + fn->length();
+                    size_t  ce  =   brace.Find(cb);
+
+                    if ( ce < _i_end )
+                    {
+                        n.kind      =   phase;
+                        n.argBegin  =   cb;
+                        n.argEnd    =   ce;
+                        n.end       =   ce + 1;
+
+                        PendingRange pc = { 0, 0, cb, ce, ePhaseIf, phase };
+                        subs[nsubs++] = pc;
+                        found = true;
+                    }
+                }
+            }
+            //  $TO_NATIVE_PATH{path} ... : the content is fully expanded first
+            if ( ! found )
+            {
+                wxString const  *   fn      =   nullptr;
+                int                 phase   =   ePhaseCount;
+
+                if      ( PHASE_ON(ePhaseNativePath)    && StartsAt(src, i, _i_end, toNativePath) )     { fn = &toNativePath;   phase = ePhaseNativePath;   }
+                else if ( PHASE_ON(ePhaseUnixPath)      && StartsAt(src, i, _i_end, toUnixPath) )       { fn = &toUnixPath;     phase = ePhaseUnixPath;     }
+                else if ( PHASE_ON(ePhaseWindowsPath)   && StartsAt(src, i, _i_end, toWindowsPath) )    { fn = &toWindowsPath;  phase = ePhaseWindowsPath;  }
+
+                if ( fn )
+                {
+                    size_t  cb  =   i + fn->length();
+                    size_t  ce  =   bracesAll.Match(cb - 1);
+
+                    n.kind      =   phase;
+                    n.argBegin  =   cb;
+                    n.argEnd    =   ce;
+                    n.end       =   ( ce < _i_end ) ? ce + 1 : _i_end;
+
+                    PendingRange pc = { 0, 0, cb, ce, ePhaseIf, ePhaseCount };
+                    subs[nsubs++] = pc;
+                    found = true;
+                }
+            }
+            //  $VAR $(VAR) ${VAR} $#GLOBAL
+            if ( ! found && PHASE_ON(ePhaseUnixVar) && ( n.afterNode || ( src[i - 1] != _T('$') ) ) )
+            {
+                size_t  nb  =   i + 1;
+                size_t  ne;
+
+                if ( ( nb < _i_end ) && ( ( src[nb] == _T('(') ) || ( src[nb] == _T('{') ) ) )
+                    ++nb;
+
+                ne = MatchMacroName(src, nb, _i_end);
+                if ( ne != nb )
+                {
+                    n.kind      =   ePhaseUnixVar;
+                    n.argBegin  =   nb;
+                    n.argEnd    =   ne;
+                    n.name      =   src.Mid(nb, ne - nb).Upper();
+                    n.end       =   ne;
+
+                    if ( ne < _i_end )
+                    {
+                        wxChar t = src[ne];
+
+                        if ( ( t == _T(')') ) || ( t == _T('}') ) || ( t == _T(' ') ) || ( t == _T('/') ) || ( t == _T('\\') ) )
+                        {
+                            n.trail = t;
+                            n.end   = ne + 1;
+                        }
+                    }
+                    found = true;
+                }
+            }
+        }
+        //  %VAR%
+        else if ( c == _T('%') )
+        {
+            if ( PHASE_ON(ePhaseDosVar) && ( n.afterNode || ( src[i - 1] != _T('%') ) ) )
+            {
+                size_t ne = MatchMacroName(src, i + 1, _i_end);
+
+                if ( ( ne != i + 1 ) && ( ne < _i_end ) && ( src[ne] == _T('%') ) )
+                {
+                    n.kind      =   ePhaseDosVar;
+                    n.argBegin  =   i + 1;
+                    n.argEnd    =   ne;
+                    n.name      =   src.Mid(i + 1, ne - i - 1).Upper();
+                    n.end       =   ne + 1;
+                    found = true;
+                }
+            }
+        }
+        //  [[script]]
+        else if ( PHASE_ON(ePhaseScript) && ( i + 1 < _i_end ) && ( src[i + 1] == _T('[') ) )
+        {
+            size_t  last;
+
+            if ( ( i + 2 < scriptFrom ) || ( i + 2 > scriptStop ) )                                 // the last ]] of a line is the same from any start before it
+            {
+                size_t p;
+
+                scriptLast = _i_end;
+                for ( p = i + 2 ; ( p + 1 < _i_end ) && ( src[p] != _T('\n') ) ; p++ )
+                    if ( ( src[p] == _T(']') ) && ( src[p + 1] == _T(']') ) )
+                        scriptLast = p;
+
+                scriptFrom = i + 2;
+                scriptStop = p;
+            }
+            last = ( ( scriptLast < _i_end ) && ( scriptLast >= i + 2 ) ) ? scriptLast : _i_end;
+
+            if ( last < _i_end )
+            {
+                n.kind      =   ePhaseScript;
+                n.argBegin  =   i + 2;
+                n.argEnd    =   last;
+                n.end       =   last + 2;
+                found = true;
+            }
+        }
+
+        if ( ! found )
+        {
+            ++i;
+            continue;
+        }
+
+        if ( text < i )                                                                             // flush the literal
+            nodes.push_back( MacroNode(ePhaseText, text, i) );
+
+        for ( int k = 0 ; k < nsubs ; k++ )
+        {
+            subs[k].node = static_cast< int >( nodes.size() );
+            pending.push_back(subs[k]);
+        }
+        nodes.push_back(n);
+
+        i       =   n.end;
+        text    =   i;
+    }
+
+    if ( text < _i_end )
+        nodes.push_back( MacroNode(ePhaseText, text, _i_end) );
+
+    _o_count = static_cast< int >( nodes.size() ) - _o_first;
+
+    for ( PendingRange const & r : pending )
+    {
+        int first, count;
+
+        CompileRange(_io_tpl, r.begin, r.end, r.from, r.to, first, count);
+        _io_tpl.nodes[r.node].sub     [r.slot] = first;
+        _io_tpl.nodes[r.node].subCount[r.slot] = count;
+    }
+
+    #undef PHASE_ON
+}
+//  ................................................................................................
+//  MacroTemplateCache
+//  ................................................................................................
+namespace
+{
+inline size_t TemplateHash(wxString const & _i_source, int _i_from_phase)
+{
+    return wxStringHash()(_i_source) ^ ( static_cast< size_t >( _i_from_phase ) * 0x9e3779b9u );
+}
+} // namespace
+
+MacrosManager::MacroTemplateCache::MacroTemplateCache(size_t _i_capacity)
+    : m_Capacity(_i_capacity)
+{
+}
+
+MacrosManager::MacroTemplatePtr MacrosManager::MacroTemplateCache::Get(wxString const & _i_source, int _i_from_phase, Counters & _io_counters)
+{
+    size_t                                                  h       =   TemplateHash(_i_source, _i_from_phase);
+    std::pair< EntryIndex::iterator, EntryIndex::iterator > range   =   m_Index.equal_range(h);
+    //  ............................................................................................
+    for ( EntryIndex::iterator it = range.first ; it != range.second ; ++it )
+    {
+        MacroTemplate const & tpl = **it->second;
+
+        if ( ( tpl.fromPhase == _i_from_phase ) && ( tpl.source == _i_source ) )
+        {
+            m_Lru.splice(m_Lru.begin(), m_Lru, it->second);                                         // iterators stay valid
+            ++_io_counters.templateHits;
+            return m_Lru.front();
+        }
+    }
+    //  ............................................................................................
+    //  miss : compile, and drop the least recently used one if full
+    ++_io_counters.templateMisses;
+
+    std::shared_ptr< MacroTemplate > tpl(new MacroTemplate);
+    CompileMacros(*tpl, _i_source, _i_from_phase);
+
+    if ( m_Lru.size() >= m_Capacity )
+    {
+        MacroTemplate const & old = *m_Lru.back();
+
+        range = m_Index.equal_range( TemplateHash(old.source, old.fromPhase) );
+
+        for ( EntryIndex::iterator it = range.first ; it != range.second ; ++it )
+        {
+            if ( it->second == --m_Lru.end() )
+            {
+                m_Index.erase(it);
+                break;
+            }
+        }
+        m_Lru.pop_back();
+        ++_io_counters.templateEvictions;
+    }
+
+    m_Lru.push_front(tpl);
+    m_Index.insert( EntryIndex::value_type(h, m_Lru.begin()) );
+
+    return m_Lru.front();
+}
+
+void MacrosManager::MacroTemplateCache::Clear()
+{
+    m_Index.clear();
+    m_Lru.clear();
+}
+//  ................................................................................................
+//  MacroTemplate evaluation
+//  ................................................................................................
+void MacrosManager::ResetCounters()
+{
+    m_Counters.templateHits         =   0;
+    m_Counters.templateMisses       =   0;
+    m_Counters.templateEvictions    =   0;
+    m_Counters.resultHits           =   0;
+    m_Counters.resultMisses         =   0;
+    m_Counters.resultVolatile       =   0;
+    m_Counters.resultDropped        =   0;
+    m_Counters.resultEvictions      =   0;
+    m_Counters.varHits              =   0;
+    m_Counters.varMisses            =   0;
+    m_Counters.varCycles            =   0;
+    m_Counters.envHits              =   0;
+    m_Counters.envMisses            =   0;
+    m_Counters.builtinFetches       =   0;
+    m_Counters.scriptCompiles       =   0;
+    m_Counters.scriptRuns           =   0;
+    m_Counters.scriptPureHits       =   0;
+    m_Counters.pathHits             =   0;
+    m_Counters.pathMisses           =   0;
+    m_Counters.macrosMerges         =   0;
+}
+
+unsigned long MacrosManager::ResultsStamp() const
+{
+    //  the vars views and eLayerTarget are selected by the key ( project, target, compiler ) and
+    //  their contents move with the owners' generations, hence with the global one. eLayerTime
+    //  is left out : its macros make the result volatile, as the editor position and selection
+    //  do ( eLayerEditor only moves with the editor's file ).
+    return      CompileOptionsBase::GetGlobalOptionsGeneration()                                   // var edits go through VarsChanged()
+            +   m_Layers[eLayerGlobal   ].generation
+            +   m_Layers[eLayerProject  ].generation
+            +   m_Layers[eLayerEditor   ].generation
+            +   m_Layers[eLayerStdPaths ].generation
+            +   m_ResultsExternalGen;
+}
+
+void MacrosManager::ResultsClear()
+{
+    m_Results.clear();
+    m_ResultsLru.clear();
+    m_DepsIndex.clear();
+    m_DepsIndexLive = 0;
+}
+
+void MacrosManager::ResultsAdd(size_t _i_hash, ResultEntry const & _i_entry, size_t _i_capacity)
+{
+    MacroDeps const & d = _i_entry.deps;
+    //  ............................................................................................
+    while ( ! m_ResultsLru.empty() && ( m_ResultsLru.size() >= _i_capacity ) )
+        ResultsEvict();
+
+    m_ResultsLru.push_front(_i_entry);
+    m_ResultsLru.front().hash = _i_hash;
+    m_Results.insert( ResultMap::value_type(_i_hash, m_ResultsLru.begin()) );
+
+    for ( wxString const & name : d.macros  )   m_DepsIndex.insert( DepsIndex::value_type(name, _i_hash) );
+    for ( wxString const & name : d.globals )   m_DepsIndex.insert( DepsIndex::value_type(name, _i_hash) );
+    for ( wxString const & name : d.env     )   m_DepsIndex.insert( DepsIndex::value_type(name, _i_hash) );
+    m_DepsIndexLive += d.macros.size() + d.globals.size() + d.env.size();
+
+    if ( m_DepsIndex.size() > 2 * m_DepsIndexLive + 1024 )                                          // mostly evicted results : once in a while
+        DepsIndexRebuild();
+}
+
+void MacrosManager::DepsIndexRebuild()
+{
+    m_DepsIndex.clear();
+    m_DepsIndexLive = 0;
+
+    for ( ResultEntry const & e : m_ResultsLru )
+    {
+        for ( wxString const & name : e.deps.macros  )  m_DepsIndex.insert( DepsIndex::value_type(name, e.hash) );
+        for ( wxString const & name : e.deps.globals )  m_DepsIndex.insert( DepsIndex::value_type(name, e.hash) );
+        for ( wxString const & name : e.deps.env     )  m_DepsIndex.insert( DepsIndex::value_type(name, e.hash) );
+        m_DepsIndexLive += e.deps.macros.size() + e.deps.globals.size() + e.deps.env.size();
+    }
+}
+
+void MacrosManager::ResultsEvict()
+{
+    ResultList::iterator    last    =   --m_ResultsLru.end();
+    const size_t            hash    =   last->hash;
+    //  ............................................................................................
+    std::pair< ResultMap::iterator, ResultMap::iterator > results = m_Results.equal_range(hash);
+
+    for ( ResultMap::iterator r = results.first ; r != results.second ; ++r )
+    {
+        if ( r->second == last )
+        {
+            m_Results.erase(r);
+            break;
+        }
+    }
+
+    //  its m_DepsIndex entries are left : VarsChanged() checks the results they lead to, and a
+    //  name read by many results has many entries, searching them on each eviction would cost
+    m_DepsIndexLive -= last->deps.macros.size() + last->deps.globals.size() + last->deps.env.size();
+    m_ResultsLru.pop_back();
+    ++m_Counters.resultEvictions;
+}
+
+void MacrosManager::MergeDeps(MacroDeps & _io_into, MacroDeps const & _i_from)
+{
+    _io_into.macros .insert( _i_from.macros .begin(), _i_from.macros .end() );
+    _io_into.globals.insert( _i_from.globals.begin(), _i_from.globals.end() );
+    _io_into.env    .insert( _i_from.env    .begin(), _i_from.env    .end() );
+    _io_into.isVolatile = _io_into.isVolatile || _i_from.isVolatile;
+}
+
+namespace
+{
+inline bool DepsRead(MacrosManager::MacroDeps const & _i_deps, wxString const & _i_name)
+{
+    return _i_deps.macros.count(_i_name) || _i_deps.globals.count(_i_name) || _i_deps.env.count(_i_name);
+}
+
+/// What read only generation tracked state may be kept : the global user vars and the environment have none.
+inline bool DepsKeepable(MacrosManager::MacroDeps const & _i_deps)
+{
+    return ( ! _i_deps.isVolatile ) && _i_deps.globals.empty() && _i_deps.env.empty();
+}
+
+/** Key of a result in the results cache : the same input comes from every target of a
+  * build, so its hash alone would gather them all in one bucket.
+  */
+inline size_t ResultKey(size_t _i_input_hash, void const * _i_project, void const * _i_target, void const * _i_compiler, bool _i_subrequest)
+{
+    size_t h = _i_input_hash;
+    //  ............................................................................................
+    h = ( h ^ std::hash< void const * >()(_i_project)  ) * 0x100000001b3ull;
+    h = ( h ^ std::hash< void const * >()(_i_target)   ) * 0x100000001b3ull;
+    h = ( h ^ std::hash< void const * >()(_i_compiler) ) * 0x100000001b3ull;
+
+    return h ^ static_cast< size_t >( _i_subrequest );
+}
+
+/** Capacity of the results cache while _i_project builds. A build expands a few inputs per
+  * file and target ( the command lines, the probes ), and a rebuild asks for them in the same
+  * order : if they do not all fit, the least recently used one is always the next one asked
+  * for, and the rebuild finds none.
+  */
+size_t ResultsCapacity(cbProject const * _i_project)
+{
+    static const size_t s_MinResults    =   4096;
+    static const size_t s_MaxResults    =   65536;                                                  // about 64 MB for command lines of 1 KB
+    static const size_t s_PerFile       =   4;
+    static const size_t s_PerTarget     =   32;                                                     // link, pre / post build steps, ...
+    size_t              n;
+    //  ............................................................................................
+    if ( ! _i_project )
+        return s_MinResults;
+
+    n = static_cast< size_t >( _i_project->GetBuildTargetsCount() ) * ( s_PerFile * _i_project->GetFilesList().size() + s_PerTarget );
+
+    return std::min( std::max(n, s_MinResults), s_MaxResults );
+}
+}
+
+void MacrosManager::GetDependents(wxString const & _i_name, wxArrayString & _o_inputs) const
+{
+    std::set< ResultEntry const * >                     seen;                                       // a name may be indexed twice for the same hash
+    std::pair< DepsIndex::const_iterator, DepsIndex::const_iterator > names = m_DepsIndex.equal_range(_i_name);
+    //  ............................................................................................
+    for ( DepsIndex::const_iterator n = names.first ; n != names.second ; ++n )
+    {
+        std::pair< ResultMap::const_iterator, ResultMap::const_iterator > results = m_Results.equal_range(n->second);
+
+        for ( ResultMap::const_iterator r = results.first ; r != results.second ; ++r )
+            if ( DepsRead(r->second->deps, _i_name) && seen.insert(&*r->second).second )
+                _o_inputs.Add(r->second->input);
+    }
+}
+
+void MacrosManager::VarsChanged(wxArrayString const & _i_keys)
+{
+    for ( size_t i = 0 ; i < _i_keys.GetCount() ; i++ )
+    {
+        const wxString  name    =   _i_keys[i].Upper();                                             // the macro names are upper-cased
+        std::pair< DepsIndex::iterator, DepsIndex::iterator > names = m_DepsIndex.equal_range(name);
+        //  ........................................................................................
+        for ( DepsIndex::iterator n = names.first ; n != names.second ; ++n )
+        {
+            std::pair< ResultMap::iterator, ResultMap::iterator > results = m_Results.equal_range(n->second);
+
+            for ( ResultMap::iterator r = results.first ; r != results.second ; )
+            {
+                if ( DepsRead(r->second->deps, name) )
+                {
+                    MacroDeps const & d = r->second->deps;
+
+                    m_DepsIndexLive -= d.macros.size() + d.globals.size() + d.env.size();
+                    m_ResultsLru.erase(r->second);
+                    r = m_Results.erase(r);
+                    ++m_Counters.resultDropped;
+                }
+                else
+                    ++r;
+            }
+        }
+
+        m_DepsIndex.erase(names.first, names.second);                                               // the other names of the dropped results stay, harmless
+    }
+}
+
+void MacrosManager::OnVarsModified(wxArrayString const & _i_keys)
+{
+    Get()->VarsChanged(_i_keys);                                                                    // registered by the ctor, removed by the dtor
+}
+
+void MacrosManager::InvalidateResults()
+{
+    ++m_ResultsExternalGen;
+    m_Env.clear();
+    m_Paths.clear();
+}
+
+void MacrosManager::EnvChanged(wxString const & _i_name)
+{
+    m_Env.erase( platform::windows ? _i_name.Upper() : _i_name );                                  // no result nor resolved var read it
+    ++m_EnvGeneration;                                                                              // ResolvedStamp() : the /*pure*/ scripts
+}
+
+bool MacrosManager::EnvGet(wxString const & _i_name, wxString & _o_value)
+{
+    static const size_t     s_MaxEnv    =   4096;
+    //  ............................................................................................
+    EnvCache::const_iterator it = m_Env.find( platform::windows ? _i_name.Upper() : _i_name );
+
+    if ( it != m_Env.end() )
+    {
+        ++m_Counters.envHits;
+        _o_value = it->second.value;
+        return it->second.found;
+    }
+    ++m_Counters.envMisses;
+
+    if ( m_Env.size() >= s_MaxEnv )
+        m_Env.clear();
+
+    EnvEntry & e = m_Env[ platform::windows ? _i_name.Upper() : _i_name ];
+
+    e.found = wxGetEnv(_i_name, &e.value);
+    _o_value = e.value;
+    return e.found;
+}
+
+void MacrosManager::PathGet(int _i_kind, wxString const & _i_input, ExpandContext & _io_ctx, wxString & _o_value)
+{
+    static const size_t     s_MaxPaths  =   4096;
+    //  ............................................................................................
+    if ( ! _io_ctx.cwdChecked )
+    {
+        wxString cwd = wxGetCwd();
+
+        if ( cwd != m_PathsCwd )
+        {
+            m_Paths.clear();
+            m_PathsCwd = cwd;
+        }
+        _io_ctx.cwdChecked = true;                                                                  // a ReplaceMacros() does not move the cwd
+    }
+
+    wxString            key =   ( ( _i_kind == ePhaseAbsolutePath ) ? _T("A") : _T("8") ) + _i_input;
+    MacrosMap::iterator it  =   m_Paths.find(key);
+
+    if ( it != m_Paths.end() )
+    {
+        ++m_Counters.pathHits;
+        _o_value = it->second;
+        return;
+    }
+    ++m_Counters.pathMisses;
+
+    if ( m_Paths.size() >= s_MaxPaths )
+        m_Paths.clear();
+
+    wxFileName fn(_i_input);
+    fn.MakeAbsolute(); // make absolute before translating to 8.3 notation
+    _o_value = ( _i_kind == ePhaseAbsolutePath ) ? fn.GetFullPath() : fn.GetShortPath();
+    m_Paths[key] = _o_value;
+}
+
+void MacrosManager::ProfileEnable(bool _i_enable)
+{
+    if ( _i_enable && ! m_Profile )
+    {
+        m_ProfileMacros.clear();
+        m_ProfileConstructs.clear();
+        m_ProfileSlowest.clear();
+        m_ProfileEvaluations = 0;
+    }
+    m_Profile = _i_enable;
+}
+
+unsigned long long MacrosManager::ProfileNow()
+{
+    return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+void MacrosManager::ProfileAdd(ProfileMap & _io_map, wxString const & _i_key, unsigned long long _i_start, size_t _i_chars)
+{
+    ProfileEntry & e = _io_map[_i_key];
+    //  ............................................................................................
+    e.count +=  1;
+    e.ns    +=  ProfileNow() - _i_start;
+    e.chars +=  _i_chars;
+}
+
+void MacrosManager::ProfileTemplateTime(wxString const & _i_source, unsigned long long _i_start)
+{
+    static const size_t     s_MaxSlowest    =   20;
+    static const size_t     s_MaxSource     =   1024;
+    const unsigned long long ns             =   ProfileNow() - _i_start;
+    ProfileTemplate         t;
+    size_t                  i;
+    //  ............................................................................................
+    ++m_ProfileEvaluations;
+
+    if ( ( m_ProfileSlowest.size() == s_MaxSlowest ) && ( ns <= m_ProfileSlowest.back().ns ) )
+        return;
+
+    t.source    =   _i_source.Left(s_MaxSource);
+    t.ns        =   ns;
+
+    for ( i = 0 ; i < m_ProfileSlowest.size() ; i++ )                                               // the same template is listed once
+    {
+        if ( m_ProfileSlowest[i].source != t.source )
+            continue;
+        if ( m_ProfileSlowest[i].ns >= ns )
+            return;
+        m_ProfileSlowest.erase(m_ProfileSlowest.begin() + i);
+        break;
+    }
+
+    for ( i = 0 ; ( i < m_ProfileSlowest.size() ) && ( m_ProfileSlowest[i].ns >= ns ) ; i++ ) {}
+    m_ProfileSlowest.insert(m_ProfileSlowest.begin() + i, t);
+
+    if ( m_ProfileSlowest.size() > s_MaxSlowest )
+        m_ProfileSlowest.pop_back();
+}
+
+namespace
+{
+/// _i_text as a JSON string, quoted.
+wxString JsonString(wxString const & _i_text)
+{
+    wxString out;
+    //  ............................................................................................
+    out.reserve(_i_text.length() + 2);
+    out.append(1u, _T('"'));
+
+    for ( size_t i = 0 ; i < _i_text.length() ; i++ )
+    {
+        const wxChar c = _i_text[i];
+
+        switch ( c )
+        {
+            case _T('"')    :   out.append(_T("\\\""));                                             break;
+            case _T('\\')   :   out.append(_T("\\\\"));                                             break;
+            case _T('\n')   :   out.append(_T("\\n"));                                              break;
+            case _T('\r')   :   out.append(_T("\\r"));                                              break;
+            case _T('\t')   :   out.append(_T("\\t"));                                              break;
+            default         :
+                if ( (unsigned)c < 0x20 )
+                    out.append(wxString::Format(_T("\\u%04x"), (unsigned)c));
+                else
+                    out.append(1u, c);
+        }
+    }
+
+    out.append(1u, _T('"'));
+    return out;
+}
+
+/// ns to the JSON number of µs ; an integer, whatever the locale's decimal point.
+wxString JsonMicroseconds(unsigned long long _i_ns)
+{
+    return wxString::Format(_T("%") wxLongLongFmtSpec _T("u"), (wxULongLong_t)( _i_ns / 1000 ));
+}
+} // namespace
+
+bool MacrosManager::ProfileDump(wxString const & _i_filename) const
+{
+    typedef std::vector< std::pair< unsigned long long, wxString > > Rows;                          // ns, JSON object : the slowest first
+
+    const ProfileMap    *   maps[]      =   { &m_ProfileConstructs, &m_ProfileMacros };
+    const wxChar        *   names[]     =   { _T("constructs"), _T("macros") };
+    wxString                filename    =   _i_filename;
+    wxString                json;
+    //  ............................................................................................
+    if ( filename.IsEmpty() )
+        filename = ConfigManager::GetConfigFolder() + wxFILE_SEP_PATH + _T("macros-profile.json");
+
+    json << _T("{\n  \"enabled\": ") << ( m_Profile ? _T("true") : _T("false") )
+         << _T(",\n  \"evaluations\": ") << wxString::Format(_T("%lu"), m_ProfileEvaluations);
+
+    for ( int m = 0 ; m < 2 ; m++ )
     {
-        replace.Empty();
-        search = m_RE_DOS.GetMatch(buffer, 2);
+        Rows rows;
 
-        wxString var = m_RE_DOS.GetMatch(buffer, 3).Upper();
+        for ( ProfileMap::const_iterator it = maps[m]->begin() ; it != maps[m]->end() ; ++it )
+        {
+            ProfileEntry const & e = it->second;
 
-        if (var.GetChar(0) == _T('#'))
-            replace = UnixFilename(m_UserVarMan->Replace(var));
-        else
+            rows.push_back( std::make_pair(e.ns, _T("{ \"name\": ") + JsonString(it->first)
+                + _T(", \"count\": ") + wxString::Format(_T("%lu"), e.count)
+                + _T(", \"us\": ") + JsonMicroseconds(e.ns)
+                + _T(", \"chars\": ") + wxString::Format(_T("%") wxLongLongFmtSpec _T("u"), (wxULongLong_t)e.chars) + _T(" }")) );
+        }
+        std::sort(rows.rbegin(), rows.rend());
+
+        json << _T(",\n  \"") << names[m] << _T("\": [");
+        for ( size_t i = 0 ; i < rows.size() ; i++ )
+            json << ( i ? _T(",") : _T("") ) << _T("\n    ") << rows[i].second;
+        json << ( rows.empty() ? _T("]") : _T("\n  ]") );
+    }
+
+    json << _T(",\n  \"slowest_templates\": [");
+    for ( size_t i = 0 ; i < m_ProfileSlowest.size() ; i++ )
+    {
+        json << ( i ? _T(",") : _T("") ) << _T("\n    { \"us\": ") << JsonMicroseconds(m_ProfileSlowest[i].ns)
+             << _T(", \"source\": ") << JsonString(m_ProfileSlowest[i].source) << _T(" }");
+    }
+    json << ( m_ProfileSlowest.empty() ? _T("]") : _T("\n  ]") ) << _T("\n}\n");
+
+    wxFFile file(filename, _T("w"));
+
+    if ( ! file.IsOpened() || ! file.Write(json, wxConvUTF8) )
+        return false;
+
+    Manager::Get()->GetLogManager()->Log(_("Macros profile written to ") + filename);
+    return true;
+}
+
+void MacrosManager::OnCompilerStarted(cb_unused CodeBlocksEvent & _i_event)
+{
+    m_Env.clear();                                                                                  // the environment of the build is read again
+}
+
+void MacrosManager::OnCompilerFinished(cb_unused CodeBlocksEvent & _i_event)
+{
+    if ( m_Profile )
+        ProfileDump();
+}
+
+namespace
+{
+wxString s_ScriptOutput;                                                                            // what the running snippet printed
+
+/// Print function of the VM while a snippet runs : its output is the value of [[script]].
+void CaptureScriptOutput(HSQUIRRELVM /*v*/, const SQChar * _i_format, ...)
+{
+    std::vector< SQChar >   buffer  (1024);
+    va_list                 vl;
+    int                     n;
+    //  ............................................................................................
+    for ( ; ; )
+    {
+        va_start(vl, _i_format);
+        n = vsnprintf(&buffer[0], buffer.size(), _i_format, vl);
+        va_end(vl);
+
+        if ( n < 0 )
+            return;
+        if ( static_cast< size_t >( n ) < buffer.size() )
+            break;
+        buffer.resize(n + 1);
+    }
+
+    s_ScriptOutput << cbC2U(&buffer[0]);
+}
+
+/** Closures of the [[script]] snippets, by text. They belong to the VM : the cache is dropped
+  * if the VM changes, and when full ( the snippets of a workspace are few ).
+  */
+class ScriptClosures
+{
+    public:
+        ScriptClosures() : m_Vm(nullptr)    {   }
+
+        SquirrelObject const *  Find(wxString const & _i_snippet)
         {
-            if (var.compare(const_COIN) == 0)
-                replace.assign(1u, rand() & 1 ? _T('1') : _T('0'));
-            else if (var.compare(const_RANDOM) == 0)
-                replace = wxString::Format(_T("%d"), rand() & 0xffff);
-            else
+            if ( m_Vm != SquirrelVM::GetVMPtr() )
             {
-                MacrosMap::iterator it;
-                if ((it = m_Macros.find(var)) != m_Macros.end())
-                    replace = it->second;
+                m_Closures.clear();
+                m_Vm = SquirrelVM::GetVMPtr();
             }
+
+            ClosureMap::const_iterator it = m_Closures.find(_i_snippet);
+
+            return ( it != m_Closures.end() ) ? &it->second : nullptr;
+        }
+
+        SquirrelObject const &  Add(wxString const & _i_snippet, SquirrelObject const & _i_closure)
+        {
+            static const size_t s_MaxClosures = 512;
+
+            if ( m_Closures.size() >= s_MaxClosures )
+                m_Closures.clear();
+            return m_Closures[_i_snippet] = _i_closure;
         }
 
-        if (replace.IsEmpty())
-            wxGetEnv(var, &replace);
+        void                    Drop(wxString const & _i_snippet)   {   m_Closures.erase(_i_snippet);   }
+
+    private:
+        typedef std::unordered_map< wxString, SquirrelObject, wxStringHash, wxStringEqual > ClosureMap;
+
+        HSQUIRRELVM     m_Vm;
+        ClosureMap      m_Closures;
+};
+
+ScriptClosures & Closures()
+{
+    static ScriptClosures s_Closures;
+    return s_Closures;
+}
+} // namespace
+
+wxString MacrosManager::RunScript(wxString const & _i_snippet)
+{
+    static const wxString   s_Pure      (_T("/*pure*/"));
+    const bool              pure        =   _i_snippet.Strip(wxString::leading).StartsWith(s_Pure);
+    const unsigned long     stamp       =   ResolvedStamp();
+    wxString                output;
+    //  ............................................................................................
+    if ( stamp != m_ScriptsStamp )
+    {
+        m_ScriptsPure.clear();
+        m_ScriptsFailed.clear();
+        m_ScriptsStamp = stamp;
+    }
+
+    if ( m_ScriptsFailed.count(_i_snippet) )                                                        // its errors were displayed
+        return wxEmptyString;
 
-        buffer.Replace(search, replace, false);
+    if ( pure )
+    {
+        MacrosMap::const_iterator it = m_ScriptsPure.find(_i_snippet);
+        if ( it != m_ScriptsPure.end() )
+        {
+            ++m_Counters.scriptPureHits;
+            return it->second;
+        }
     }
 
-    if (!subrequest)
+    HSQUIRRELVM     vm      =   SquirrelVM::GetVMPtr();
+    SQPRINTFUNCTION former  =   sq_getprintfunc(vm);
+    wxString        outer;                                                                          // output of the snippet running this one, if any
+
+    outer.swap(s_ScriptOutput);
+    sq_setprintfunc(vm, CaptureScriptOutput);
+    try
+    {
+        SquirrelObject          closure;                                                            // a copy : a nested snippet may drop the cache
+        SquirrelObject const *  found   =   Closures().Find(_i_snippet);
+
+        if ( found )
+            closure = *found;
+        else
+        {
+            ++m_Counters.scriptCompiles;
+            closure = Closures().Add( _i_snippet, SquirrelVM::CompileBuffer(cbU2C(_i_snippet), "MacrosManager") );
+        }
+
+        ++m_Counters.scriptRuns;
+        SquirrelVM::RunScript(closure);
+    }
+    catch (SquirrelError& e)                                                                        // reported as LoadBuffer() does
     {
-        buffer.Replace(_T("%%"), _T("%"));
-        buffer.Replace(_T("$$"), _T("$"));
+        sq_setprintfunc(vm, former);
+        s_ScriptOutput.swap(outer);
+        Closures().Drop(_i_snippet);
+        if ( ResolvedStamp() == stamp )                                                             // else the snippet changed the state
+            m_ScriptsFailed.insert(_i_snippet);
+        Manager::Get()->GetScriptingManager()->DisplayErrors(&e);
+        return wxEmptyString;                                                                       // as LoadBufferRedirectOutput()
     }
+    sq_setprintfunc(vm, former);
+    output.swap(s_ScriptOutput);
+    s_ScriptOutput.swap(outer);
+
+    if ( pure && ( ResolvedStamp() == stamp ) )                                                     // else the snippet changed the state
+        m_ScriptsPure[_i_snippet] = output;
+
+    return output;
 }
 
-wxString MacrosManager::EvalCondition(const wxString& in_cond, const wxString& true_clause, const wxString& false_clause, const ProjectBuildTarget* target)
+void MacrosManager::CollapseEscapes(wxString & _io_buffer)
+{
+    wxString::iterator  r   =   _io_buffer.begin();
+    wxString::iterator  w   =   _io_buffer.begin();
+    wxString::iterator  e   =   _io_buffer.end();
+    //  ............................................................................................
+    //  one pass, same result as Replace(_T("%%"), _T("%")) then Replace(_T("$$"), _T("$")) :
+    //  a pair of one char never makes a pair of the other one
+    while ( r != e )
+    {
+        wxChar c = *r++;
+
+        if ( ( ( c == _T('%') ) || ( c == _T('$') ) ) && ( r != e ) && ( *r == c ) )
+            ++r;
+        *w++ = c;
+    }
+
+    _io_buffer.erase(w, e);
+}
+
+void MacrosManager::LookupMacro(wxString const & _i_upper_name, wxString & _o_value)
+{
+    int layer = eLayerCount;
+    //  ............................................................................................
+    if (_i_upper_name.GetChar(0) == _T('#'))
+    {
+        const unsigned long long start = m_Profile ? ProfileNow() : 0;
+
+        _o_value = UnixFilename(m_UserVarMan->Replace(_i_upper_name));
+        m_Deps->globals.insert(_i_upper_name);
+        if ( start )
+            ProfileAdd(m_ProfileConstructs, s_ProfileGlobal, start, _o_value.length());
+    }
+    else if (_i_upper_name.compare(const_COIN) == 0)
+    {
+        _o_value.assign(1u, rand() & 1 ? _T('1') : _T('0'));
+        m_Deps->isVolatile = true;
+    }
+    else if (_i_upper_name.compare(const_RANDOM) == 0)
+    {
+        _o_value = wxString::Format(_T("%d"), rand() & 0xffff);
+        m_Deps->isVolatile = true;
+    }
+    else
+    {
+        m_Deps->macros.insert(_i_upper_name);                                                       // found or not : defining it changes the result
+
+        if ( wxString const * value = FindMacro(_i_upper_name, &layer) )
+        {
+            _o_value = *value;
+            if ( layer == eLayerTime )                                                              // $NOW, $TODAY, ... unless a var hides them
+                m_Deps->isVolatile = true;
+            else if ( ( layer == eLayerEditor ) && ( Builtins().Find(_i_upper_name) >= eSlotEditorLine ) )
+                m_Deps->isVolatile = true;                                                          // read again after each RecalcVars()
+        }
+        else
+            _o_value.clear();
+    }
+}
+
+void MacrosManager::ExpandInto(wxString const & _i_text, int _i_from_phase, ExpandContext & _io_ctx, wxString & _io_out)
+{
+    static const int    s_MaxDepth  =   64;                                                         // the former loops never ended on A=$(A)
+    //  ............................................................................................
+    if ( FindDelimiter(_i_text, 0, _i_text.length()) == _i_text.length() )
+    {
+        _io_out.append(_i_text);
+        return;
+    }
+
+    if ( _io_ctx.depth >= s_MaxDepth )
+    {
+        ++m_ResolveTaint;                                                                           // truncated : not a resolved value
+        _io_out.append(_i_text);
+        return;
+    }
+
+    MacroTemplatePtr tpl = m_Templates.Get(_i_text, _i_from_phase, m_Counters);
+
+    ++_io_ctx.depth;
+    EvalNodes(*tpl, 0, tpl->count, _io_ctx, _io_out);
+    --_io_ctx.depth;
+}
+
+unsigned long MacrosManager::ResolvedStamp() const
+{
+    unsigned long stamp = CompileOptionsBase::GetGlobalGeneration() + m_ResultsExternalGen + m_EnvGeneration;  // vars edits included
+    //  ............................................................................................
+    for ( MacrosLayer const & l : m_Layers )                                                        // the views too : they move when rebound
+        stamp += l.generation;
+
+    return stamp;
+}
+
+void MacrosManager::ResolveVar(MacroTemplate const & _i_tpl, MacroNode const & _i_node, ExpandContext & _io_ctx, wxString & _io_out)
+{
+    static const size_t     s_MaxResolved   =   8192;
+    const unsigned long     stamp           =   ResolvedStamp();
+    const bool              trail           =   ( _i_node.trail == _T('/') ) || ( _i_node.trail == _T('\\') ) || ( _i_node.trail == _T(' ') );
+    wxString                key;
+    wxString                value;
+    ResolvedVar             r;
+    MacroDeps           *   outer           =   m_Deps;
+    const unsigned long     taint           =   m_ResolveTaint;
+    //  ............................................................................................
+    if ( stamp != m_ResolvedStamp )
+    {
+        m_Resolved.clear();
+        m_CyclesReported.clear();
+        m_ResolvedStamp = stamp;
+    }
+
+    //  the phase the value is expanded from, and the trail that is expanded with it ( "$A/" with
+    //  A empty gives "/", not the environment's A ) are part of the key
+    key.reserve(_i_node.name.length() + 2);
+    key.append(1u, ( _i_node.kind == ePhaseUnixVar ) ? _T('$') : _T('%'));
+    key.append(1u, trail ? _i_node.trail : _T('.'));
+    key.append(_i_node.name);
+
+    ResolvedMap::const_iterator it = m_Resolved.find(key);
+    if ( it != m_Resolved.end() )
+    {
+        ++m_Counters.varHits;
+        MergeDeps(*m_Deps, it->second.deps);
+        _io_out.append(it->second.value);
+        return;
+    }
+
+    for ( size_t i = 0 ; i < m_Resolving.size() ; i++ )
+    {
+        if ( m_Resolving[i] != _i_node.name )
+            continue;
+
+        wxString chain;
+
+        for ( size_t j = i ; j < m_Resolving.size() ; j++ )
+            chain << m_Resolving[j] << _T(" -> ");
+        chain << _i_node.name;
+
+        ++m_Counters.varCycles;
+        ++m_ResolveTaint;
+        if ( m_CyclesReported.insert(chain).second )
+            Manager::Get()->GetLogManager()->LogWarning(_("Warning: cycle in the variables ") + chain + _(", left unexpanded"));
+
+        _io_out.append(_i_tpl.source, _i_node.begin, _i_node.end - _i_node.begin);
+        return;
+    }
+    ++m_Counters.varMisses;
+
+    m_Deps = &r.deps;
+    m_Resolving.push_back(_i_node.name);
+
+    LookupMacro(_i_node.name, value);
+
+    if ( trail ) // make non-braced variables work
+        value.append(_i_node.trail);
+
+    if ( value.IsEmpty() )
+    {
+        const unsigned long long start = m_Profile ? ProfileNow() : 0;
+
+        EnvGet(_i_node.name, value);
+        m_Deps->env.insert(_i_node.name);
+        if ( start )
+            ProfileAdd(m_ProfileConstructs, s_ProfileEnv, start, value.length());
+    }
+
+    ExpandInto(value, _i_node.kind, _io_ctx, r.value);
+
+    m_Resolving.pop_back();
+    m_Deps = outer;
+    MergeDeps(*m_Deps, r.deps);
+    _io_out.append(r.value);
+
+    //  not stored : $COIN & co, the global user vars and the environment, what went through a
+    //  cycle, and what was resolved while the state moved
+    if ( ( ! DepsKeepable(r.deps) ) || ( m_ResolveTaint != taint ) || ( ResolvedStamp() != stamp ) )
+        return;
+
+    if ( m_Resolved.size() >= s_MaxResolved )
+        m_Resolved.clear();
+
+    m_Resolved[key] = std::move(r);
+}
+
+namespace
+{
+inline bool IsPathSeparator(wxChar c)
+{
+    return ( c == _T('/') ) || ( c == _T('\\') );
+}
+
+/** UnixFilename() of globals.cpp, in place and in one pass : each run of separators becomes
+  * one separator of the format. A UNC name ( \\server ) is always converted to the Windows
+  * format, and keeps its two leading backslashes. Nothing is allocated : the string only
+  * shrinks.
+  */
+void ConvertSeparators(wxString & _io_path, wxPathFormat _i_format)
+{
+    const size_t    len     =   _io_path.length();
+    const bool      unc     =   ( len >= 2 ) && ( _io_path[0] == _T('\\') ) && ( _io_path[1] == _T('\\') );
+    const bool      win     =   unc || ( _i_format == wxPATH_WIN ) || ( ( _i_format == wxPATH_NATIVE ) && platform::windows );
+    const wxChar    sep     =   win ? _T('\\') : _T('/');
+    size_t          r       =   0;
+    size_t          w       =   0;
+    bool            inRun   =   false;
+    //  ............................................................................................
+    if ( unc )
+    {
+        for ( r = 2 ; ( r < len ) && IsPathSeparator(_io_path[r]) ; r++ ) {}
+        w       =   2;
+        inRun   =   true;
+    }
+
+    for ( ; r < len ; r++ )
+    {
+        const wxChar    c   =   _io_path[r];
+        wxChar          o   =   c;
+
+        if ( IsPathSeparator(c) )
+        {
+            if ( inRun )
+                continue;
+            o       =   sep;
+            inRun   =   true;
+        }
+        else
+            inRun   =   false;
+
+        if ( ( w != r ) || ( o != c ) )                                                             // most chars stay in place
+            _io_path[w] = o;
+        ++w;
+    }
+
+    if ( w != len )
+        _io_path.Truncate(w);
+}
+} // namespace
+
+void MacrosManager::EvalNodes(MacroTemplate const & _i_tpl, int _i_first, int _i_count, ExpandContext & _io_ctx, wxString & _io_out)
+{
+    wxString    const   &   src     =   _i_tpl.source;
+    wxString                value;
+    //  ............................................................................................
+    for ( int k = _i_first ; k < _i_first + _i_count ; k++ )
+    {
+        MacroNode const & n = _i_tpl.nodes[k];
+
+        value.clear();
+
+        const unsigned long long    start   =   ( m_Profile && ( n.kind != ePhaseText ) ) ? ProfileNow() : 0;   // inclusive : the nested expansions count in
+        const size_t                mark    =   _io_out.length();
+
+        switch ( n.kind )
+        {
+        case ePhaseText:
+            _io_out.append(src, n.begin, n.end - n.begin);
+            break;
+
+        case ePhaseIf:
+        {
+            int clause = EvalIf(_i_tpl, n, _io_ctx) ? 0 : 1;
+
+            if ( n.sub[clause] >= 0 )
+                EvalNodes(_i_tpl, n.sub[clause], n.subCount[clause], _io_ctx, _io_out);
+            break;
+        }
+
+        case ePhaseScript:
+            m_Deps->isVolatile = true;                                                              // a script may read anything, even /*pure*/ : its deps are unknown
+            value = RunScript(src.Mid(n.argBegin, n.argEnd - n.argBegin));
+            ExpandInto(value, ePhaseScript, _io_ctx, _io_out);
+            break;
+
+        case ePhaseAbsolutePath:
+        case ePhase83Path:
+        {
+            wxString input;
+
+            m_Deps->isVolatile = true;                                                              // depends on the cwd and the file system
+            EvalNodes(_i_tpl, n.sub[0], n.subCount[0], _io_ctx, input);
+            PathGet(n.kind, input, _io_ctx, value);
+            ExpandInto(value, n.kind, _io_ctx, _io_out);
+            break;
+        }
+
+        case ePhaseNativePath:
+        case ePhaseUnixPath:
+        case ePhaseWindowsPath:
+        {
+            bool subrequest = _io_ctx.subrequest;
+
+            _io_ctx.subrequest = true;
+            EvalNodes(_i_tpl, n.sub[0], n.subCount[0], _io_ctx, value);
+            _io_ctx.subrequest = subrequest;
+
+            if ( n.kind == ePhaseNativePath )
+                ConvertSeparators(value, wxPATH_NATIVE);
+            else
+                ConvertSeparators(value, ( n.kind == ePhaseUnixPath ) ? wxPATH_UNIX : wxPATH_WIN);
+            ExpandInto(value, n.kind, _io_ctx, _io_out);
+            break;
+        }
+
+        case ePhaseRemoveQuotes:
+        {
+            EvalNodes(_i_tpl, n.sub[0], n.subCount[0], _io_ctx, value);
+            value.Trim().Trim(false);
+            if (value.StartsWith(wxT("$")))
+            {
+                wxString content;
+
+                ExpandInto(value, ePhaseIf, _io_ctx, content);
+                if ( ! _io_ctx.subrequest )
+                    CollapseEscapes(content);
+                value.swap(content);
+            }
+            if (value.Len()>2 && value.StartsWith(wxT("\"")) && value.EndsWith(wxT("\"")))
+                value = value.Mid(1,value.Len()-2); // with first and last char (the quotes) removed
+            ExpandInto(value, ePhaseRemoveQuotes, _io_ctx, _io_out);
+            break;
+        }
+
+        case ePhaseUnixVar:
+        case ePhaseDosVar:
+        {
+            const wxChar prefix = ( n.kind == ePhaseUnixVar ) ? _T('$') : _T('%');
+
+            if ( n.afterNode && ! _io_out.empty() && ( _io_out.Last() == prefix ) )                 // ([^$]|^) checked on what precedes now
+            {
+                _io_out.append(src, n.begin, n.end - n.begin);
+                break;
+            }
+
+            ResolveVar(_i_tpl, n, _io_ctx, _io_out);
+            break;
+        }
+
+        default:
+            break;
+        }
+
+        if ( start )
+        {
+            if ( n.kind >= ePhaseUnixVar )
+                ProfileAdd(m_ProfileMacros    , n.name                              , start, _io_out.length() - mark);
+            else
+                ProfileAdd(m_ProfileConstructs, s_ProfileConstructs[n.kind - ePhaseIf], start, _io_out.length() - mark);
+        }
+    }
+}
+//  ................................................................................................    ERG-
+
+void MacrosManager::ReplaceMacros(wxString& buffer, const ProjectBuildTarget* target, bool subrequest)
 {
-    enum condition_codes {EQ = 1, LT = 2, GT = 4, NE = 8};
+    if (buffer.IsEmpty())
+        return;
+
+    //  ............................................................................................    ERG+
+    //  ERG static const wxString delim(_T("$%["));
+    //  ERG if ( buffer.find_first_of(delim) == wxString::npos )
+    if ( FindDelimiter(buffer, 0, buffer.length()) == buffer.length() )
+    //  ............................................................................................    ERG-
+        return;
+
+    const cbProject* project = target
+                             ? target->GetParentProject()
+                             : Manager::Get()->GetProjectManager()->GetActiveProject();
+    EditorBase* editor = Manager::Get()->GetEditorManager()->GetActiveEditor();
 
-    wxString cond(in_cond);
-    wxString result;
+    if (!target)
+    {
+        if (project)
+        {
+            // use the currently compiling target
+            target = project->GetCurrentlyCompilingTarget();
+            // if none,
+            if (!target)
+                // use the last known active target
+                target = project->GetBuildTarget(project->GetActiveBuildTarget());
+        }
+    }
+    if (project != m_LastProject || target != m_LastTarget || (editor && (editor->GetFilename() != m_ActiveEditorFilename))
+                    //  ............................................................................    ERG+
+                    //  ERG || (project && (UnixFilename(project->GetBasePath()) != m_ProjectDir))
+                    //  ERG || (UnixFilename(m_ProjectWxFileName.GetFullName()) != m_ProjectFilename)
+                    //  The base path and the file name derive from the project's filename : comparing
+                    //  it costs no wxFileName and no copy on each call.
+                    || (project && (project->GetFilename() != m_ProjectPath))
+                    //  ERG || (target && (target->GetTitle() != m_TargetName)) )
+                    || LayersAreStale(project, target) )                                            // covers the target's title
+                    //  ............................................................................    ERG-
+        RecalcVars(project, editor, target);
 
-    ReplaceMacros(cond, target, true);
+    //  ............................................................................................    ERG+
+    //  The same inputs come again and again while nothing changes ( the command line of each
+    //  file, Compiler::IsValid() probes ) : their results are cached until the stamp moves.
+    const unsigned long         stamp           =   ResultsStamp();
+    CompileOptionsBase const *  compiler        =   m_Layers[eLayerCompilerVars].owner;
+    const size_t                hash            =   ResultKey(wxStringHash()(buffer), project, target, compiler, subrequest);
+    //  ............................................................................................
+    if ( stamp != m_ResultsStamp )
+    {
+        ResultsClear();
+        m_ResultsStamp = stamp;
+    }
 
-    if (!m_RE_IfSp.Matches(in_cond))
-        return false_clause;
+    std::pair< ResultMap::iterator, ResultMap::iterator > cached = m_Results.equal_range(hash);
 
+    for ( ResultMap::iterator it = cached.first ; it != cached.second ; ++it )
+    {
+        ResultEntry const & e = *it->second;
 
-    wxString cmpToken(m_RE_IfSp.GetMatch(in_cond, 3).Strip(wxString::both));
-    wxString left(m_RE_IfSp.GetMatch(in_cond, 2).Strip(wxString::both));
-    wxString right(m_RE_IfSp.GetMatch(in_cond, 4).Strip(wxString::both));
+        if ( ( e.target == target ) && ( e.project == project ) && ( e.compiler == compiler ) && ( e.subrequest == subrequest ) && ( e.input == buffer ) )
+        {
+            m_ResultsLru.splice(m_ResultsLru.begin(), m_ResultsLru, it->second);                    // iterators stay valid
+            ++m_Counters.resultHits;
+            if ( m_Deps )                                                                           // nested in an evaluation, or ExpandWithDeps()
+                MergeDeps(*m_Deps, e.deps);
+            buffer = e.result;
+            return;
+        }
+    }
+    ++m_Counters.resultMisses;
+
+    //  The buffer is compiled in one linear scan ( or found in the cache ), the template is
+    //  evaluated into a new buffer : the former regex loops rescanned and rewrote the whole
+    //  buffer for every substitution.
+    MacroTemplatePtr    tpl     =   m_Templates.Get(buffer, ePhaseIf, m_Counters);
+    ExpandContext       ctx;
+    wxString            out;
+    ResultEntry         e;
+    MacroDeps       *   outer   =   m_Deps;                                                         // ReplaceMacros() is reentered by $if conditions
+    //  ............................................................................................
+    ctx.target      =   target;
+    ctx.subrequest  =   subrequest;
+    ctx.depth       =   0;
+    ctx.cwdChecked  =   false;
+
+    const unsigned long long start = m_Profile ? ProfileNow() : 0;
+
+    m_Deps = &e.deps;
+    out.reserve( buffer.length() + buffer.length() / 2 );
+    EvalNodes(*tpl, 0, tpl->count, ctx, out);
+    m_Deps = outer;
 
+    if (!subrequest)
+        CollapseEscapes(out);
 
-    int compare = left.Cmp(right);
-    if (compare == 0)
-        compare = EQ;
-    else if (compare < 0)
-        compare = LT | NE;
-    else if (compare > 0)
-        compare = GT | NE;
+    if ( start )
+        ProfileTemplateTime(buffer, start);
 
+    if ( outer )
+        MergeDeps(*outer, e.deps);
 
-    if (cmpToken.IsEmpty())
+    if ( ! DepsKeepable(e.deps) )
+        ++m_Counters.resultVolatile;
+    else if ( ResultsStamp() == stamp )                                                             // else the state moved while evaluating
     {
-        if (cond.IsEmpty() || cond.IsSameAs(_T("0")) || cond.IsSameAs(_T("false")))
-            return false_clause;
-        return true_clause;
+        e.input         =   buffer;
+        e.project       =   project;
+        e.target        =   target;
+        e.compiler      =   compiler;
+        e.subrequest    =   subrequest;
+        e.result        =   out;
+        ResultsAdd(hash, e, ResultsCapacity(project));
     }
 
-    int condCode = 0;
+    buffer.swap(out);
+    //  ............................................................................................    ERG-
+}
+
+void MacrosManager::ExpandWithDeps(wxString & _io_buffer, ProjectBuildTarget const * _i_target, MacroDeps & _o_deps)
+{
+    MacroDeps * outer = m_Deps;
+    //  ............................................................................................
+    _o_deps = MacroDeps();
+
+    m_Deps = &_o_deps;                                                                              // ReplaceMacros() merges what it read, cached or not
+    ReplaceMacros(_io_buffer, _i_target);
+    m_Deps = outer;
+
+    if ( outer )
+        MergeDeps(*outer, _o_deps);
+}
+
+wxString MacrosManager::EvalCondition(const wxString& in_cond, const wxString& true_clause, const wxString& false_clause, const ProjectBuildTarget* target)
+{
+    //  ............................................................................................    ERG+
+    return IsConditionTrue(in_cond, target) ? true_clause : false_clause;
+}
 
-    if (cmpToken.IsSameAs(_T("==")) || cmpToken.IsSameAs(_T("=")))
-        condCode = EQ;
-    if (cmpToken.IsSameAs(_T("<")))
-        condCode = LT;
-    if (cmpToken.IsSameAs(_T(">")))
-        condCode = GT;
-    if (cmpToken.IsSameAs(_T("<=")))
-        condCode = EQ | LT;
-    if (cmpToken.IsSameAs(_T(">=")))
-        condCode = EQ | GT;
-    if (cmpToken.IsSameAs(_T("!=")))
-        condCode = NE;
+bool MacrosManager::IsConditionTrue(const wxString& in_cond, const ProjectBuildTarget* target)
+{
+    IfCondition     c       =   ParseCondition(in_cond, 0, in_cond.length());
+    wxString        left    =   in_cond.Mid(c.leftBegin , c.leftEnd  - c.leftBegin );
+    wxString        right   =   in_cond.Mid(c.rightBegin, c.rightEnd - c.rightBegin);
+    //  ............................................................................................
+    //  the $if( ) of a template are evaluated by EvalIf() : this is the same on a raw condition.
+    //  The operands of a comparison are compared as written, only a bare condition is expanded.
+    if ( c.op == eIfTrue )
+        ReplaceMacros(left , target, true);
+
+    return IfHolds(c.op, false, left, right);
+
+    //  ERG enum condition_codes {EQ = 1, LT = 2, GT = 4, NE = 8};
+    //  ERG
+    //  ERG wxString cond(in_cond);
+    //  ERG wxString result;
+    //  ERG
+    //  ERG ReplaceMacros(cond, target, true);
+    //  ERG
+    //  ERG if (!m_RE_IfSp.Matches(in_cond))
+    //  ERG     return false_clause;
+    //  ERG
+    //  ERG
+    //  ERG wxString cmpToken(m_RE_IfSp.GetMatch(in_cond, 3).Strip(wxString::both));
+    //  ERG wxString left(m_RE_IfSp.GetMatch(in_cond, 2).Strip(wxString::both));
+    //  ERG wxString right(m_RE_IfSp.GetMatch(in_cond, 4).Strip(wxString::both));
+    //  ERG
+    //  ERG
+    //  ERG int compare = left.Cmp(right);
+    //  ERG if (compare == 0)
+    //  ERG     compare = EQ;
+    //  ERG else if (compare < 0)
+    //  ERG     compare = LT | NE;
+    //  ERG else if (compare > 0)
+    //  ERG     compare = GT | NE;
+    //  ERG
+    //  ERG
+    //  ERG if (cmpToken.IsEmpty())
+    //  ERG {
+    //  ERG     if (cond.IsEmpty() || cond.IsSameAs(_T("0")) || cond.IsSameAs(_T("false")))
+    //  ERG         return false_clause;
+    //  ERG     return true_clause;
+    //  ERG }
+    //  ERG
+    //  ERG int condCode = 0;
+    //  ERG
+    //  ERG if (cmpToken.IsSameAs(_T("==")) || cmpToken.IsSameAs(_T("=")))
+    //  ERG     condCode = EQ;
+    //  ERG if (cmpToken.IsSameAs(_T("<")))
+    //  ERG     condCode = LT;
+    //  ERG if (cmpToken.IsSameAs(_T(">")))
+    //  ERG     condCode = GT;
+    //  ERG if (cmpToken.IsSameAs(_T("<=")))
+    //  ERG     condCode = EQ | LT;
+    //  ERG if (cmpToken.IsSameAs(_T(">=")))
+    //  ERG     condCode = EQ | GT;
+    //  ERG if (cmpToken.IsSameAs(_T("!=")))
+    //  ERG     condCode = NE;
+    //  ERG
+    //  ERG return condCode & compare ? true_clause : false_clause;
+    //  ............................................................................................    ERG-
+}
 
-    return condCode & compare ? true_clause : false_clause;
+bool MacrosManager::EvalIf(MacroTemplate const & _i_tpl, MacroNode const & _i_node, ExpandContext & _io_ctx)
+{
+    wxString    left;
+    wxString    right;
+    //  ............................................................................................
+    if ( _i_node.cond == eIfNever )
+        return false;
+    if ( _i_node.cond == eIfAlways )
+        return true;
+
+    EvalNodes(_i_tpl, _i_node.sub[2], _i_node.subCount[2], _io_ctx, left);
+    if ( _i_node.cond > eIfTrue )
+        EvalNodes(_i_tpl, _i_node.sub[3], _i_node.subCount[3], _io_ctx, right);
+
+    return IfHolds(_i_node.cond, _i_node.numeric, left, right);
 }
 
 int MacrosManager::MatchBrace(const wxString& buffer, int index)
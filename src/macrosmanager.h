@@ -0,0 +1,480 @@
+/*
+ * This file is part of the Code::Blocks IDE and licensed under the GNU Lesser General Public License, version 3
+ * http://www.gnu.org/licenses/lgpl-3.0.html
+ */
+
+#ifndef MACROSMANAGER_H
+#define MACROSMANAGER_H
+
+#include "settings.h"
+#include "manager.h"
+#include <wx/regex.h>
+#include <wx/filename.h>
+#include <wx/hashmap.h>
+//  ................................................................................................    ERG+
+#include <vector>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <set>
+//  ................................................................................................    ERG-
+
+#ifndef CB_PRECOMP
+    #include "globals.h"
+#endif
+
+// forward decls
+class wxMenuBar;
+class cbProject;
+class ProjectBuildTarget;
+class EditorBase;
+class UserVariableManager;
+//  ................................................................................................    ERG+
+class CompileOptionsBase;
+class CodeBlocksEvent;
+class wxEvtHandler;
+//  ................................................................................................    ERG-
+
+WX_DECLARE_STRING_HASH_MAP(wxString, MacrosMap);
+
+class DLLIMPORT MacrosManager : public Mgr<MacrosManager>
+{
+    public:
+        friend class Mgr<MacrosManager>;
+        friend class Manager; // give Manager access to our private members
+        void CreateMenu(wxMenuBar* menuBar);
+        void ReleaseMenu(wxMenuBar* menuBar);
+        void ReplaceMacros(wxString& buffer, const ProjectBuildTarget* target = nullptr, bool subrequest = false);
+        wxString ReplaceMacros(const wxString& buffer, const ProjectBuildTarget* target = nullptr);
+        void ReplaceEnvVars(wxString& buffer) { ReplaceMacros(buffer); }  // remains for backward compatibility
+        void RecalcVars(const cbProject* project, EditorBase* editor, const ProjectBuildTarget* target);
+        void ClearProjectKeys();
+        void Reset();
+        //  ........................................................................................    ERG+
+        //  ERG const MacrosMap& GetMacros() const { return m_Macros; }
+        const MacrosMap& GetMacros() const;                                                         //!< all the macros, merged by precedence
+
+        /** Macro layers, from the lowest to the highest precedence : a macro defined in several
+          * layers takes its value from the highest one, as the successive writes into the single
+          * m_Macros map used to do. The vars layers form the scope chain target -> project ->
+          * compiler ; they copy nothing, they only point at the owner, whose active vars are
+          * looked up by upper-cased key. The environment is the last resort of ReplaceMacros().
+          */
+        enum
+        {
+            eLayerGlobal        ,                                                                   //!< app paths, platform commands, workspace
+            eLayerProject       ,                                                                   //!< PROJECT_*, <TARGET>_OUTPUT_* of the project
+            eLayerCompilerVars  ,                                                                   //!< custom vars of the target's compiler
+            eLayerProjectVars   ,                                                                   //!< custom vars of the project
+            eLayerTargetVars    ,                                                                   //!< custom vars of the target
+            eLayerTarget        ,                                                                   //!< TARGET_* of the target
+            eLayerEditor        ,                                                                   //!< ACTIVE_EDITOR_*
+            eLayerStdPaths      ,                                                                   //!< GET_*_DIR
+            eLayerTime          ,                                                                   //!< TODAY, NOW, ...
+
+            eLayerCount
+        };
+
+        unsigned long GetLayerGeneration(int _i_layer) const { return m_Layers[_i_layer].generation; }  //!< incremented each time the layer is rebuilt
+
+        /// Instrumentation counters, since the start or the last ResetCounters().
+        struct Counters
+        {
+            unsigned long   templateHits;                                                           //!< compiled template found in the cache
+            unsigned long   templateMisses;                                                         //!< template compiled
+            unsigned long   templateEvictions;                                                      //!< least recently used template dropped
+            unsigned long   resultHits;                                                             //!< ReplaceMacros() answered from the results cache
+            unsigned long   resultMisses;                                                           //!< ReplaceMacros() evaluated
+            unsigned long   resultVolatile;                                                         //!< evaluated result not cached : $COIN, $RANDOM, dates, [[script]], $#GLOBAL, environment, ...
+            unsigned long   resultDropped;                                                          //!< cached result dropped by VarsChanged()
+            unsigned long   resultEvictions;                                                        //!< least recently used result dropped
+            unsigned long   varHits;                                                                //!< var reference answered from the resolved vars
+            unsigned long   varMisses;                                                              //!< var reference resolved
+            unsigned long   varCycles;                                                              //!< var reference met again while resolving it
+            unsigned long   envHits;                                                                //!< environment fallback answered from the cache, found or not
+            unsigned long   envMisses;                                                              //!< environment fallback read with wxGetEnv()
+            unsigned long   builtinFetches;                                                         //!< lazy builtin computed : editor position / selection, standard path, date
+            unsigned long   scriptCompiles;                                                         //!< [[script]] compiled into a closure
+            unsigned long   scriptRuns;                                                             //!< [[script]] closure run
+            unsigned long   scriptPureHits;                                                         //!< /*pure*/ [[script]] answered from its output of the stamp
+            unsigned long   pathHits;                                                               //!< $TO_ABSOLUTE_PATH{ } / $TO_83_PATH{ } answered from the paths cache
+            unsigned long   pathMisses;                                                             //!< $TO_ABSOLUTE_PATH{ } / $TO_83_PATH{ } computed with wxFileName
+            unsigned long   macrosMerges;                                                           //!< GetMacros() merged the layers again
+        };
+
+        const Counters& GetCounters() const { return m_Counters; }
+        void            ResetCounters();
+
+        /** Drop the cached ReplaceMacros() results, the resolved vars, the environment snapshot
+          * and the paths. The caches follow the macro layers and the CompileOptionsBase objects
+          * by themselves, and keep nothing read from the global user vars or the environment :
+          * this is for a reload of everything, for an environment changed behind C::B, or for
+          * the file system under the paths.
+          */
+        void            InvalidateResults();
+
+        /** The environment variable _i_name was set or unset : drop its cached value. To be
+          * called after each wxSetEnv() / wxUnsetEnv() of C::B ( Compiler::EvalXMLCondition(),
+          * a [[script]], the envvars plugin ) : the environment is not read again before.
+          */
+        void            EnvChanged      (wxString const & _i_name);
+
+        /** Profile of the expansions, off by default : per macro name and per construct ( $if,
+          * [[script]], path functions, $#GLOBAL, environment fallback ), the expansions, the time
+          * spent in them ( the nested expansions included ) and the chars produced ; and the
+          * slowest templates evaluated. ProfileDump() writes it as JSON, at the end of each build
+          * while enabled, or from the Tools menu.
+          */
+        void            ProfileEnable   (bool _i_enable);                                           //!< enabling starts a new profile
+        bool            ProfileEnabled  () const    { return m_Profile; }
+        bool            ProfileDump     (wxString const & _i_filename = wxEmptyString) const;       //!< default : macros-profile.json in the config folder
+
+        /// What an expansion read.
+        struct MacroDeps
+        {
+            MacroDeps() : isVolatile(false)     {   }
+
+            std::set< wxString >    macros;                                                         //!< upper-cased names looked up in the layers, found or not
+            std::set< wxString >    globals;                                                        //!< global user vars, as #NAME
+            std::set< wxString >    env;                                                            //!< environment vars read because the macro was empty
+            bool                    isVolatile;                                                     //!< read $COIN, $RANDOM, a date, a [[script]], ... : the sets are not the whole story
+        };
+
+        void            ExpandWithDeps  (wxString & _io_buffer, ProjectBuildTarget const * _i_target, MacroDeps & _o_deps);  //!< ReplaceMacros(), and what it read
+
+        /** Reverse index of the cached results : the inputs whose result read _i_name ( a macro or
+          * environment name, upper-cased, or #NAME for a global user var ).
+          */
+        void            GetDependents   (wxString const & _i_name, wxArrayString & _o_inputs) const;
+
+        /// Drop the cached results which read one of these vars ; called on var edits, through OnVarsModified().
+        void            VarsChanged     (wxArrayString const & _i_keys);
+        //  ........................................................................................    ERG-
+    protected:
+        const ProjectBuildTarget* m_LastTarget;
+        const cbProject*          m_LastProject;
+        wxFileName                m_ProjectWxFileName;
+        wxFileName                m_WorkspaceWxFileName;
+        wxString                  m_ProjectFilename;
+        wxString                  m_ProjectName;
+        wxString                  m_ProjectDir;
+        wxString                  m_ProjectTopDir;
+        wxString                  m_ProjectFiles;
+        wxString                  m_Makefile;
+        wxString                  m_TargetOutputDir;
+        wxString                  m_TargetName;
+        wxString                  m_TargetOutputBaseName;
+        wxString                  m_TargetOutputFilename;
+        wxString                  m_TargetFilename;
+        wxString                  m_WorkspaceFilename;
+        wxString                  m_WorkspaceName;
+        wxString                  m_WorkspaceDir;
+        wxString                  m_AppPath;
+        wxString                  m_DataPath;
+        wxString                  m_Plugins;
+        wxString                  m_ActiveEditorFilename;
+        int                       m_ActiveEditorLine;
+        int                       m_ActiveEditorColumn;
+        //  ........................................................................................    ERG+
+        //  ERG MacrosMap                 m_Macros;
+        mutable MacrosMap         m_Macros;                                                         //!< GetMacros() cache
+        mutable unsigned long     m_MacrosStamp;                                                    //!< sum of the layers generations m_Macros was merged with
+        mutable unsigned long     m_MacrosOwnerGen[eLayerCount];                                    //!< GetGeneration() of each viewed owner m_Macros was merged with
+        wxString                  m_ProjectPath;                                                    //!< project->GetFilename() m_ProjectDir and m_ProjectFilename derive from
+
+        struct MacrosLayer
+        {
+            MacrosLayer() : owner(nullptr), ownerGen(0), generation(0), valid(false), view(false)   {   }
+
+            MacrosMap                   macros;                                                     //!< empty for a view
+            CompileOptionsBase const *  owner;                                                      //!< object the layer was built from, or viewed, if any
+            unsigned long               ownerGen;                                                   //!< owner's GetGeneration() ( or any stamp ) when built
+            unsigned long               generation;                                                 //!< incremented by each rebuild / invalidation
+            bool                        valid;
+            bool                        view;                                                       //!< macros are the active vars of owner
+        };
+        MacrosLayer               m_Layers[eLayerCount];
+
+        /** Builtin macros ( APP_PATH, PROJECT_DIR, TARGET_CC, TODAY, ... ) : their names are fixed,
+          * each is a slot of its layer rather than a map entry, and the aliases of a name share
+          * its slot ( PROJECT_DIR, PROJECTDIR, ... ). A perfect hash maps a name to its slot. The
+          * names made at run time ( <TARGET>_OUTPUT_FILE ) stay in the layer's map.
+          *
+          * The costly ones are lazy : RecalcVars() only marks them, and the first reference
+          * computes them ( the editor position and selection, the standard paths, the dates ).
+          */
+        mutable std::vector< wxString > m_Slots;
+        mutable std::vector< bool >     m_SlotSet;                                                  //!< cleared with the slot's layer ; unset slots are not defined
+        mutable std::vector< bool >     m_SlotLazy;                                                 //!< defined, but computed by the first SlotGet()
+
+        void            SlotSet         (int _i_slot, wxString const & _i_value);
+        void            SlotLazy        (int _i_first, int _i_last);                                //!< define [_i_first, _i_last], computed when read
+        wxString const& SlotGet         (int _i_slot) const;
+        void            SlotFetch       (int _i_slot) const;                                        //!< compute a lazy slot, and the ones computed with it
+
+        MacrosMap     & LayerRebuild    (int _i_layer, CompileOptionsBase const * _i_owner = nullptr, unsigned long _i_owner_gen = 0);
+        void            LayerInvalidate (int _i_layer);
+        bool            LayerIsUpToDate (int _i_layer, CompileOptionsBase const * _i_owner, unsigned long _i_owner_gen) const;
+        void            LayerBindVars   (int _i_layer, CompileOptionsBase const * _i_owner);        //!< make the layer a view of _i_owner's vars
+        bool            LayersAreStale  (cbProject const * _i_project, ProjectBuildTarget const * _i_target) const;
+        wxString const* FindMacro       (wxString const & _i_upper_key, int * _o_layer = nullptr) const;    //!< walk the layers from the highest ; nullptr if none
+
+        /** ReplaceMacros() compiles the buffer into a MacroTemplate in one linear scan, then
+          * evaluates the template into a new buffer. Each construct is matched as the former
+          * regex did, and its result goes through the phases that followed it in the former
+          * pipeline : e.g. the output of a [[script]] still goes through the path functions and
+          * the vars, a var value only goes through the vars.
+          */
+        enum
+        {
+            ePhaseIf            ,                                                                   //!< $if(cond){true}{false}
+            ePhaseScript        ,                                                                   //!< [[script]]
+            ePhaseAbsolutePath  ,                                                                   //!< $TO_ABSOLUTE_PATH{}
+            ePhase83Path        ,                                                                   //!< $TO_83_PATH{}
+            ePhaseNativePath    ,                                                                   //!< $TO_NATIVE_PATH{}
+            ePhaseUnixPath      ,                                                                   //!< $TO_UNIX_PATH{}
+            ePhaseWindowsPath   ,                                                                   //!< $TO_WINDOWS_PATH{}
+            ePhaseRemoveQuotes  ,                                                                   //!< $REMOVE_QUOTES{}
+            ePhaseUnixVar       ,                                                                   //!< $VAR $(VAR) ${VAR} $#GLOBAL
+            ePhaseDosVar        ,                                                                   //!< %VAR%
+
+            ePhaseCount         ,
+            ePhaseText          =   ePhaseCount                                                     //!< MacroNode::kind of a literal
+        };
+
+        struct MacroNode
+        {
+            MacroNode(int _i_kind = ePhaseText, size_t _i_begin = 0, size_t _i_end = 0)
+                :   kind(_i_kind), begin(_i_begin), end(_i_end), argBegin(_i_begin), argEnd(_i_end), trail(0), afterNode(false),
+                    cond(0), numeric(false)
+            {
+                for ( int k = 0 ; k < 4 ; k++ )
+                {
+                    sub     [k] = -1;
+                    subCount[k] = 0;
+                }
+            }
+
+            int             kind;                                                                   //!< ePhase* of the construct, or ePhaseText
+            size_t          begin;                                                                  //!< source span of the construct
+            size_t          end;
+            size_t          argBegin;                                                               //!< source span of the raw argument : condition, script, content
+            size_t          argEnd;
+            wxString        name;                                                                   //!< vars : upper-cased name
+            wxChar          trail;                                                                  //!< $VAR : the char matched after the name, or 0
+            bool            afterNode;                                                              //!< vars : not preceded by a literal, the prefix rule is checked on the output
+            int             cond;                                                                   //!< $if : operator of the condition, parsed once ( eIf* ) ; a comparison is resolved then
+            bool            numeric;                                                                //!< $ifnum : the operands are compared as numbers
+            int             sub     [4];                                                            //!< first node of the clauses ( 0, 1 ) and operands ( 2, 3 ) / of the content ( 0 ) ; -1 if none
+            int             subCount[4];
+        };
+
+        struct MacroTemplate
+        {
+            wxString                    source;
+            std::vector< MacroNode >    nodes;                                                      //!< sequences are contiguous ; the top one is first
+            int                         count;                                                      //!< nodes of the top sequence
+            int                         fromPhase;                                                  //!< first phase matched in the top sequence
+        };
+        typedef std::shared_ptr< MacroTemplate const > MacroTemplatePtr;                            //!< a template stays alive while evaluated, even if evicted
+
+        /** Compiled templates, keyed by the hash of ( source, first phase ). The same command
+          * lines are expanded for each file of a build : they are compiled once, and the least
+          * recently used ones are dropped beyond the capacity.
+          */
+        class MacroTemplateCache
+        {
+            public:
+                explicit MacroTemplateCache(size_t _i_capacity);
+
+                MacroTemplatePtr    Get     (wxString const & _i_source, int _i_from_phase, Counters & _io_counters);  //!< compile on miss
+                void                Clear   ();
+                size_t              Size    ()  const   { return m_Lru.size();  }
+
+            private:
+                typedef std::list< MacroTemplatePtr >                               EntryList;      //!< most recently used first
+                typedef std::unordered_multimap< size_t, EntryList::iterator >      EntryIndex;
+
+                size_t          m_Capacity;
+                EntryList       m_Lru;
+                EntryIndex      m_Index;
+        };
+
+        struct ExpandContext
+        {
+            ProjectBuildTarget const *  target;
+            bool                        subrequest;                                                 //!< no final $$ / %% collapse
+            int                         depth;                                                      //!< nested expansions of results
+            bool                        cwdChecked;                                                 //!< m_PathsCwd compared to the cwd in this expansion
+        };
+
+        static  void    CompileMacros   (MacroTemplate & _o_tpl, wxString const & _i_source, int _i_from_phase);
+        static  void    CompileRange    (MacroTemplate & _io_tpl, size_t _i_begin, size_t _i_end, int _i_from_phase, int _i_to_phase, int & _o_first, int & _o_count);
+        static  void    CollapseEscapes (wxString & _io_buffer);                                    //!< $$ -> $ , %% -> %
+
+        MacroTemplateCache      m_Templates;
+        mutable Counters        m_Counters;                                                         //!< SlotFetch() and GetMacros() count in const calls
+
+        /** Results of ReplaceMacros(), keyed by the input and what selected the layers. They are
+          * valid for one results stamp : the generations of the layers that are not bound to the
+          * key, the options ( not vars ) generations of all the CompileOptionsBase objects, and
+          * InvalidateResults(). Each evaluation collects its MacroDeps in *m_Deps : a volatile
+          * result is not stored, nor one reading a global user var or the environment, which
+          * have no generation ; the others are indexed by the names they read, so that a var
+          * edit drops only the results reading that var. When full, the least recently used
+          * result is dropped ; the capacity follows the project ( ResultsCapacity() ), so that
+          * the inputs of a whole build fit.
+          */
+        struct ResultEntry
+        {
+            wxString                    input;
+            cbProject const *           project;
+            ProjectBuildTarget const *  target;
+            CompileOptionsBase const *  compiler;                                                   //!< owner of eLayerCompilerVars, kept when there is no target
+            bool                        subrequest;
+            wxString                    result;
+            MacroDeps                   deps;
+            size_t                      hash;                                                       //!< its key in m_Results : input, project, target, ...
+        };
+        typedef std::list< ResultEntry >                                                    ResultList; //!< most recently used first
+        typedef std::unordered_multimap< size_t, ResultList::iterator >                     ResultMap;
+        typedef std::unordered_multimap< wxString, size_t, wxStringHash, wxStringEqual >   DepsIndex;  //!< name -> hash of the results reading it
+
+        ResultList              m_ResultsLru;
+        ResultMap               m_Results;
+        DepsIndex               m_DepsIndex;                                                        //!< entries of the evicted results are left, until DepsIndexRebuild()
+        size_t                  m_DepsIndexLive;                                                    //!< entries of the cached results
+        unsigned long           m_ResultsStamp;
+        unsigned long           m_ResultsExternalGen;                                               //!< cf InvalidateResults()
+        MacroDeps             * m_Deps;                                                             //!< deps of the running evaluation, nullptr if none
+
+        unsigned long   ResultsStamp    () const;
+        void            ResultsClear    ();
+        void            ResultsAdd      (size_t _i_hash, ResultEntry const & _i_entry, size_t _i_capacity);
+        void            ResultsEvict    ();                                                         //!< drop the least recently used one
+        void            DepsIndexRebuild();
+        static  void    MergeDeps       (MacroDeps & _io_into, MacroDeps const & _i_from);
+
+        /** Resolved vars : what a $VAR / %VAR% reference expands to ( its value, expanded in turn
+          * down to the last nested reference ), computed once per resolver stamp and then only
+          * looked up. The stamp moves with any layer, any CompileOptionsBase ( vars included ),
+          * EnvChanged() and InvalidateResults() ; what read a global user var or the environment
+          * is not stored. The names being resolved are stacked : a name met again is a cycle,
+          * reported once with its chain and left unexpanded ; nothing resolved through a cycle
+          * is stored, the result depending on where the chain was entered.
+          */
+        struct ResolvedVar
+        {
+            wxString                    value;
+            MacroDeps                   deps;
+        };
+        typedef std::unordered_map< wxString, ResolvedVar, wxStringHash, wxStringEqual >    ResolvedMap;    //!< key : '$' or '%', trail, upper-cased name
+
+        ResolvedMap             m_Resolved;
+        unsigned long           m_ResolvedStamp;
+        std::vector< wxString > m_Resolving;                                                        //!< names being resolved, outermost first
+        unsigned long           m_ResolveTaint;                                                     //!< incremented by each cycle / depth bound met
+        std::set< wxString >    m_CyclesReported;                                                   //!< chains already logged for this stamp
+
+        /** The environment fallback of the vars, read once per name with wxGetEnv() : the
+          * absent names are kept too, the post build steps fall back on the same names again
+          * and again. The snapshot lives until EnvChanged() for the name, InvalidateResults()
+          * or the start of a build ; what read it is not cached, the environment having no
+          * generation of its own. Names are upper-cased on Windows, where the environment
+          * ignores the case.
+          */
+        struct EnvEntry
+        {
+            wxString                    value;
+            bool                        found;
+        };
+        typedef std::unordered_map< wxString, EnvEntry, wxStringHash, wxStringEqual >       EnvCache;
+
+        EnvCache                m_Env;
+        unsigned long           m_EnvGeneration;                                                    //!< incremented by EnvChanged()
+
+        bool            EnvGet          (wxString const & _i_name, wxString & _o_value);
+
+        /** [[script]] : the snippets are compiled once into closures, kept by their text ( in the
+          * cpp : they belong to the VM ), and run with their output captured. A snippet starting
+          * with the comment / *pure* / declares its output a function of the macros state : it
+          * is run once per ResolvedStamp(), the later ones reuse its output. A snippet that
+          * fails has its errors displayed and expands to nothing ; it is not run again for the
+          * same ResolvedStamp(), a var edit may have fixed it.
+          */
+        MacrosMap               m_ScriptsPure;                                                      //!< snippet -> output
+        std::set< wxString >    m_ScriptsFailed;
+        unsigned long           m_ScriptsStamp;                                                     //!< ResolvedStamp() of both
+
+        wxString        RunScript       (wxString const & _i_snippet);
+
+        /** $TO_ABSOLUTE_PATH{ } / $TO_83_PATH{ } : the wxFileName results, by function and input.
+          * They hold for one working directory : the first such function of a ReplaceMacros()
+          * reads the cwd, and the cache is dropped if it moved. InvalidateResults() drops it too,
+          * for the short names of the files created since.
+          */
+        MacrosMap               m_Paths;                                                            //!< 'A' / '8', input -> path
+        wxString                m_PathsCwd;
+
+        void            PathGet         (int _i_kind, wxString const & _i_input, ExpandContext & _io_ctx, wxString & _o_value);
+
+        struct ProfileEntry
+        {
+            ProfileEntry() : count(0), ns(0), chars(0)  {   }
+
+            unsigned long               count;
+            unsigned long long          ns;
+            unsigned long long          chars;
+        };
+        typedef std::unordered_map< wxString, ProfileEntry, wxStringHash, wxStringEqual >   ProfileMap;
+
+        struct ProfileTemplate
+        {
+            wxString                    source;                                                     //!< its first 1024 chars
+            unsigned long long          ns;                                                         //!< slowest evaluation
+        };
+
+        bool                            m_Profile;
+        ProfileMap                      m_ProfileMacros;                                            //!< by upper-cased name, #NAME for the global vars
+        ProfileMap                      m_ProfileConstructs;                                        //!< by construct : $if, [[script]], env, ...
+        std::vector< ProfileTemplate >  m_ProfileSlowest;                                           //!< slowest first
+        unsigned long                   m_ProfileEvaluations;                                       //!< templates evaluated
+        wxEvtHandler                *   m_ProfileMenu;                                              //!< Tools menu entries
+
+        static  unsigned long long  ProfileNow          ();                                         //!< ns
+                void                ProfileAdd          (ProfileMap & _io_map, wxString const & _i_key, unsigned long long _i_start, size_t _i_chars);
+                void                ProfileTemplateTime (wxString const & _i_source, unsigned long long _i_start);
+                void                OnCompilerStarted   (CodeBlocksEvent & _i_event);                   //!< drops the environment snapshot
+                void                OnCompilerFinished  (CodeBlocksEvent & _i_event);
+        static  void                OnVarsModified      (wxArrayString const & _i_keys);            //!< the vars listener of CompileOptionsBase, while the manager lives
+
+        unsigned long   ResolvedStamp   () const;
+                void    ResolveVar      (MacroTemplate const & _i_tpl, MacroNode const & _i_node, ExpandContext & _io_ctx, wxString & _io_out);
+
+                void    EvalNodes       (MacroTemplate const & _i_tpl, int _i_first, int _i_count, ExpandContext & _io_ctx, wxString & _io_out);
+                void    ExpandInto      (wxString const & _i_text, int _i_from_phase, ExpandContext & _io_ctx, wxString & _io_out);     //!< append _i_text, expanded from _i_from_phase
+                void    LookupMacro     (wxString const & _i_upper_name, wxString & _o_value);      //!< #GLOBAL, COIN, RANDOM, layers
+                bool    IsConditionTrue (const wxString& in_cond, const ProjectBuildTarget* target);
+                bool    EvalIf          (MacroTemplate const & _i_tpl, MacroNode const & _i_node, ExpandContext & _io_ctx);
+        //  ........................................................................................    ERG-
+        static int MatchBrace(const wxString& buffer, int index);
+        wxString EvalCondition(const wxString& cond, const wxString& true_clause, const wxString& false_clause, const ProjectBuildTarget* target);
+
+    private:
+        MacrosManager();
+        ~MacrosManager() override;
+
+        //  ........................................................................................    ERG+
+        //  ERG wxRegEx m_RE_Unix;
+        //  ERG wxRegEx m_RE_DOS;
+        //  ERG wxRegEx m_RE_If;
+        //  ERG wxRegEx m_RE_IfSp;
+        //  ERG wxRegEx m_RE_Script;
+        //  ERG wxRegEx m_RE_ToAbsolutePath;
+        //  ERG wxRegEx m_RE_To83Path;
+        //  ERG wxRegEx m_RE_RemoveQuotes;
+        //  ........................................................................................    ERG-
+        UserVariableManager* m_UserVarMan;
+};
+
+#endif // MACROSMANAGER_H
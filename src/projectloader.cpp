@@ -901,6 +901,9 @@ void ProjectLoader::DoEnvironment(TiXmlElement* parentNode, CompileOptionsBase*
     if (!base)
         return;
 
+    //  ............................................................................................    ERG+
+    CompileOptionsBase::VarBatch batch(*base);                                                      // one pass, one modification notification
+    //  ............................................................................................    ERG-
     TiXmlElement* node = parentNode->FirstChildElement("Environment");
     while (node)
     {
@@ -919,12 +922,15 @@ void ProjectLoader::DoEnvironment(TiXmlElement* parentNode, CompileOptionsBase*
             bool        active  = ( child->Attribute("active") != NULL ) ? true : false;
 
             if (!name.IsEmpty())
-                base->VarSet(name, UnixFilename(value), comment, active ? CompileOptionsBase::eVarActive : CompileOptionsBase::eVarInactive, false);
+                batch.Set(name, UnixFilename(value), comment, active ? CompileOptionsBase::eVarActive : CompileOptionsBase::eVarInactive);
             //  ....................................................................................    ERG-
             child = child->NextSiblingElement("Variable");
         }
         node = node->NextSiblingElement("Environment");
     }
+    //  ............................................................................................    ERG+
+    batch.Commit();
+    //  ............................................................................................    ERG-
 }
 
 namespace
@@ -1226,11 +1232,11 @@ static void SaveEnvironment(TiXmlElement* parent, CompileOptionsBase* base)
 
     TiXmlElement* node = AddElement(parent, "Environment");
 
-    for ( CustomVarHash::const_iterator * it = base->VarEnumGetFirst(CompileOptionsBase::eVarAll) ; it != nullptr ; it = base->VarEnumGetNext() )
+    for ( CustomVarEntry const & e : base->VarEnum(CompileOptionsBase::eVarAll) )
     {
-        CustomVar cv = (*it)->second;
+        CustomVar const & cv = e.var;
 
-        TiXmlElement* elem = AddElement(node, "Variable", "name", (*it)->first);
+        TiXmlElement* elem = AddElement(node, "Variable", "name", e.key);
         elem->SetAttribute("value", cbU2C(cv.value));
         //  active var <=> attribute "active" is present
         if ( cv.flags & CompileOptionsBase::eVarActive )